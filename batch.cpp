@@ -0,0 +1,295 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include "batch.h"
+#include "nnue.h"
+#include "search.h"
+
+using namespace std;
+
+struct BatchJob {
+    uint64_t index;      // position number, the order results are written in
+    uint64_t lineNumber; // for error reports
+    string line;
+};
+
+// The reader may only run `window` positions ahead of the writer, so the pending jobs plus the
+// finished results waiting for an earlier position never hold more than `window` entries.
+struct BatchState {
+    mutex lock;
+    condition_variable readerWait;
+    condition_variable workerWait;
+    condition_variable writerWait;
+    deque<BatchJob> jobs;         // read but not yet picked up by a worker
+    map<uint64_t, string> done;   // finished results not written yet
+    uint64_t nextIndex = 0;       // next position the reader hands out
+    uint64_t nextWrite = 0;       // next position the writer needs
+    uint64_t window = 0;
+    bool inputDone = false;
+};
+
+static string jsonEscape(const string& s) {
+    string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (c == '\t') {
+            out += "\\t";
+        } else if (c == '\r' || c == '\n') {
+            continue;
+        } else if ((unsigned char)c < 0x20) {
+            continue;
+        } else {
+            out += c;
+        }
+    }
+    return out;
+}
+
+// Splits an EPD or FEN line into a FEN the Position parser accepts and the EPD id opcode, if any.
+// EPD has four position fields followed by "opcode operand;" pairs, FEN has move counters instead.
+static string parseEpd(const string& line, string& id) {
+    istringstream in(line);
+    string fields[4];
+    for (string& f : fields) {
+        if (!(in >> f)) return line; // let setFromFen report it
+    }
+    string fen = fields[0] + " " + fields[1] + " " + fields[2] + " " + fields[3];
+    string rest;
+    getline(in, rest);
+
+    istringstream counters(rest);
+    int halfmove, fullmove;
+    if (counters >> halfmove >> fullmove) return fen + " " + to_string(halfmove) + " " + to_string(fullmove);
+
+    size_t at = rest.find("id ");
+    while (at != string::npos && at > 0 && rest[at - 1] != ' ' && rest[at - 1] != ';') at = rest.find("id ", at + 1);
+    if (at != string::npos) {
+        size_t start = rest.find_first_not_of(' ', at + 3);
+        if (start != string::npos && rest[start] == '"') {
+            size_t end = rest.find('"', start + 1);
+            id = rest.substr(start + 1, end == string::npos ? string::npos : end - start - 1);
+        } else if (start != string::npos) {
+            id = rest.substr(start, rest.find(';', start) - start);
+        }
+    }
+    return fen;
+}
+
+static void writeScore(ostream& out, int score) { // side to move's point of view, as in UCI
+    if (abs(score) >= MATE_SCORE - MAX_PLY) {
+        int plies = MATE_SCORE - abs(score);
+        out << ",\"mate\":" << (score > 0 ? (plies + 1) / 2 : -(plies + 1) / 2);
+    } else {
+        out << ",\"cp\":" << score * 10;
+    }
+}
+
+static void writePv(ostream& out, const Move* pv, int length) {
+    out << ",\"pv\":\"";
+    for (int i = 0; i < length; i++) out << (i ? " " : "") << moveToString(pv[i]);
+    out << "\"";
+}
+
+const size_t coldHashMegabytes = 16; // largest table cleared for every position
+
+static string analyze(Engine& engine, const BatchJob& job, const SearchLimits& limits, bool withStats) {
+    string id;
+    string fen = parseEpd(job.line, id);
+    ostringstream out;
+    out << "{\"line\":" << job.lineNumber;
+    if (!id.empty()) out << ",\"id\":\"" << jsonEscape(id) << "\"";
+
+    Position pos;
+    if (!pos.setFromFen(fen)) {
+        out << ",\"fen\":\"" << jsonEscape(job.line) << "\",\"error\":\"invalid fen\"}";
+        return out.str();
+    }
+    out << ",\"fen\":\"" << pos.fen() << "\"";
+
+    // Every position starts with fresh move ordering. A small table is cleared as well, so results do
+    // not depend on which worker got the position; wiping a large one for every line would cost more
+    // than the search, so it is only aged and may still hold entries from the worker's earlier positions.
+    if (engine.tt.sizeMegabytes() <= coldHashMegabytes) {
+        engine.clear();
+    } else {
+        engine.clearHistory();
+    }
+    engine.newSearch();
+    SearchResult r = engine.search(pos, limits);
+    int sign = pos.sideToMove == WHITE ? 1 : -1;
+    out << ",\"bestmove\":" << (r.bestMove.isNone() ? string("null") : "\"" + moveToString(r.bestMove) + "\"");
+    writeScore(out, sign * r.score);
+    out << ",\"depth\":" << r.depth << ",\"nodes\":" << r.nodes << ",\"time_ms\":" << r.timeMs;
+    writePv(out, r.pv, r.pvLength);
+    if (engine.options.multiPV > 1) { // every line, best first
+        out << ",\"lines\":[";
+        for (size_t k = 0; k < r.lines.size(); k++) {
+            const RootLine& line = r.lines[k];
+            out << (k ? "," : "") << "{\"move\":\"" << moveToString(line.pv[0]) << "\"";
+            writeScore(out, sign * line.score);
+            writePv(out, line.pv, line.pvLength);
+            out << "}";
+        }
+        out << "]";
+    }
+    if (withStats) out << ",\"stats\":" << searchStatsJson(r);
+    out << "}";
+    return out.str();
+}
+
+static void readPositions(BatchState& s, istream& in) {
+    string line;
+    uint64_t lineNumber = 0;
+    while (getline(in, line)) {
+        lineNumber++;
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == string::npos || line[start] == '#') continue; // blank lines and comments
+
+        unique_lock<mutex> lock(s.lock);
+        s.readerWait.wait(lock, [&] { return s.nextIndex - s.nextWrite < s.window; });
+        s.jobs.push_back({s.nextIndex++, lineNumber, line.substr(start)});
+        s.workerWait.notify_one();
+    }
+    lock_guard<mutex> lock(s.lock);
+    s.inputDone = true;
+    s.workerWait.notify_all();
+    s.writerWait.notify_all();
+}
+
+static void analyzePositions(BatchState& s, Engine& engine, const SearchLimits& limits, bool withStats) {
+    while (true) {
+        BatchJob job;
+        {
+            unique_lock<mutex> lock(s.lock);
+            s.workerWait.wait(lock, [&] { return !s.jobs.empty() || s.inputDone; });
+            if (s.jobs.empty()) return; // input exhausted and nothing left to do
+            job = move(s.jobs.front());
+            s.jobs.pop_front();
+        }
+        string result = analyze(engine, job, limits, withStats);
+        lock_guard<mutex> lock(s.lock);
+        s.done[job.index] = move(result);
+        if (job.index == s.nextWrite) s.writerWait.notify_one();
+    }
+}
+
+int batchCommand(int argc, char* argv[]) {
+    if (argc < 2) {
+        cerr << "usage: chess batch <file|-> [--depth N] [--movetime ms] [--nodes N] [--workers N] [--hash MB] [--window N] [--out file] [--nnue file] [--multipv K] [--stats]\n";
+        return 1;
+    }
+    string inputPath = argv[1];
+    string outputPath;
+    SearchLimits limits;
+    int workerCount = max(1u, thread::hardware_concurrency());
+    size_t hashMegabytes = 16;
+    uint64_t window = 0;
+    bool withStats = false;
+    int multiPV = 1;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--depth" && i + 1 < argc) {
+            limits.depth = stoi(argv[++i]);
+        } else if (arg == "--movetime" && i + 1 < argc) {
+            limits.movetime = stoll(argv[++i]);
+        } else if (arg == "--nodes" && i + 1 < argc) {
+            limits.nodes = stoull(argv[++i]);
+        } else if (arg == "--workers" && i + 1 < argc) {
+            workerCount = max(1, stoi(argv[++i]));
+        } else if (arg == "--hash" && i + 1 < argc) {
+            hashMegabytes = stoul(argv[++i]);
+        } else if (arg == "--window" && i + 1 < argc) {
+            window = stoull(argv[++i]);
+        } else if (arg == "--out" && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (arg == "--multipv" && i + 1 < argc) { // also report the next best root moves
+            multiPV = max(1, stoi(argv[++i]));
+        } else if (arg == "--stats") { // searchStatsJson for every position
+            withStats = true;
+        } else if (arg == "--nnue" && i + 1 < argc) {
+            nnueEnabled = nnueLoad(argv[++i]);
+            if (!nnueEnabled) {
+                cerr << "cannot load network " << argv[i] << "\n";
+                return 1;
+            }
+        } else {
+            cerr << "unknown batch option " << arg << "\n";
+            return 1;
+        }
+    }
+    if (!limits.depth && !limits.movetime && !limits.nodes) limits.depth = 8;
+
+    ifstream file;
+    if (inputPath != "-") {
+        file.open(inputPath);
+        if (!file) {
+            cerr << "cannot open " << inputPath << "\n";
+            return 1;
+        }
+    }
+    ofstream outFile;
+    if (!outputPath.empty()) {
+        outFile.open(outputPath);
+        if (!outFile) {
+            cerr << "cannot write " << outputPath << "\n";
+            return 1;
+        }
+    }
+    istream& in = inputPath == "-" ? cin : file;
+    ostream& out = outputPath.empty() ? cout : outFile;
+
+    initBitboards();
+    BatchState s;
+    s.window = window ? window : uint64_t(workerCount) * 16; // enough slack that one slow position rarely stalls the rest
+
+    vector<unique_ptr<Engine>> engines;
+    for (int i = 0; i < workerCount; i++) {
+        engines.emplace_back(new Engine(hashMegabytes));
+        engines.back()->options.threads = 1; // parallelism comes from searching positions side by side
+        engines.back()->options.multiPV = multiPV;
+    }
+    vector<thread> workers;
+    for (int i = 0; i < workerCount; i++) {
+        workers.emplace_back(analyzePositions, ref(s), ref(*engines[i]), cref(limits), withStats);
+    }
+    thread reader(readPositions, ref(s), ref(in));
+
+    // The calling thread writes results as soon as the next one in input order is finished.
+    while (true) {
+        string result;
+        bool more;
+        {
+            unique_lock<mutex> lock(s.lock);
+            s.writerWait.wait(lock, [&] { return s.done.count(s.nextWrite) || (s.inputDone && s.nextWrite == s.nextIndex); });
+            auto it = s.done.find(s.nextWrite);
+            if (it == s.done.end()) break; // everything read has been written
+            result = move(it->second);
+            s.done.erase(it);
+            s.nextWrite++;
+            more = s.done.count(s.nextWrite);
+            s.readerWait.notify_one();
+        }
+        out << result << '\n';
+        if (!more) out.flush(); // stream results out rather than holding them in the buffer
+    }
+    out.flush();
+
+    reader.join();
+    for (thread& t : workers) t.join();
+    return 0;
+}
@@ -0,0 +1,15 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+// Offline analysis of FEN/EPD files, one JSON object per position written to stdout (or --out) in
+// input order. Positions are searched concurrently, one single-threaded Engine per worker. Each
+// position is searched from a cleared hash table of up to 16 MB; a larger one is only aged between
+// positions, so results for related positions can then depend on which worker searched what before.
+// chess batch <file|-> [--depth N] [--movetime ms] [--nodes N] [--workers N] [--hash MB per worker]
+//                      [--window N] [--out file] [--multipv K]
+int batchCommand(int argc, char* argv[]);
@@ -0,0 +1,220 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench.h"
+#include "evaluate.h"
+#include "movegen.h"
+#include "nnue.h"
+#include "search.h"
+#include "timer.h"
+
+using namespace std;
+
+// Openings, middlegames with both kings exposed, and endgames, so every part of the search gets exercised.
+static const char* benchPositions[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "2rq1rk1/pb1nbppp/1p2pn2/2pp4/2PP4/1PNBPN2/PB3PPP/2RQ1RK1 w - - 0 11",
+    "r2q1rk1/ppp2ppp/2n1bn2/2b1p3/3pP3/3P1NPP/PPP1NPB1/R1BQ1RK1 b - - 0 9",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+    "8/8/4k3/3p4/3P4/4K3/8/8 w - - 0 1",
+    "4r1k1/1q3ppp/p7/1p1Q4/8/1P3P2/P5PP/3R2K1 b - - 3 30",
+};
+
+static vector<Position> loadPositions() {
+    vector<Position> positions;
+    for (const char* fen : benchPositions) {
+        Position pos;
+        pos.setFromFen(fen);
+        positions.push_back(pos);
+    }
+    return positions;
+}
+
+static void printMicro(const char* name, uint64_t calls, long long ns, uint64_t checksum) {
+    char line[160];
+    snprintf(line, sizeof(line), "  %-14s %8.2f ns/call %10.2f M/s   checksum %llu\n", name, double(ns) / double(calls),
+             double(calls) * 1000.0 / double(max(1LL, ns)), (unsigned long long)checksum);
+    cout << line;
+}
+
+// Each microbenchmark runs a fixed number of rounds over every bench position, so the checksums
+// are comparable between builds as well as the timings.
+static void runMicrobenchmarks(vector<Position>& positions, int rounds) {
+    Timer timer;
+    uint64_t calls = uint64_t(rounds) * positions.size();
+    cout << "\nMicrobenchmarks (" << calls << " calls each)\n";
+
+    uint64_t checksum = 0;
+    timer.start();
+    for (int r = 0; r < rounds; r++) {
+        for (const Position& pos : positions) {
+            MoveList moves;
+            enumerateAllMoves(pos, moves);
+            checksum += moves.size();
+        }
+    }
+    timer.stop();
+    printMicro("movegen", calls, timer.getNanoseconds(), checksum);
+
+    checksum = 0;
+    timer.start();
+    for (int r = 0; r < rounds; r++) {
+        for (const Position& pos : positions) {
+            MoveList moves;
+            enumerateCaptures(pos, moves);
+            checksum += moves.size();
+        }
+    }
+    timer.stop();
+    printMicro("captures", calls, timer.getNanoseconds(), checksum);
+
+    checksum = 0;
+    timer.start();
+    for (int r = 0; r < rounds; r++) {
+        for (const Position& pos : positions) checksum += immediateEvaluation(pos);
+    }
+    timer.stop();
+    printMicro("evaluation", calls, timer.getNanoseconds(), checksum);
+
+    if (nnueEnabled) {
+        checksum = 0;
+        timer.start();
+        for (int r = 0; r < rounds; r++) {
+            for (Position& pos : positions) checksum += nnueEvaluate(pos);
+        }
+        timer.stop();
+        printMicro("nnue", calls, timer.getNanoseconds(), checksum);
+    }
+
+    // Every legal move of every position is made and taken back, one call counting as both.
+    vector<MoveList> moveLists(positions.size());
+    uint64_t pairs = 0;
+    for (size_t i = 0; i < positions.size(); i++) {
+        enumerateAllMoves(positions[i], moveLists[i]);
+        pairs += moveLists[i].size();
+    }
+    checksum = 0;
+    timer.start();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < positions.size(); i++) {
+            Position& pos = positions[i];
+            for (Move m : moveLists[i]) {
+                UndoInfo undo;
+                pos.makeMove(m, undo);
+                checksum += pos.key;
+                pos.unmakeMove(m, undo);
+            }
+        }
+    }
+    timer.stop();
+    printMicro("make/unmake", pairs * rounds, timer.getNanoseconds(), checksum);
+}
+
+// Searches every position from a cold table, optionally printing a line for each.
+static void searchPositions(Engine& engine, const vector<Position>& positions, const SearchLimits& limits, bool print,
+                            uint64_t& totalNodes, long long& totalNs) {
+    totalNodes = 0;
+    totalNs = 0;
+    Timer timer;
+    for (size_t i = 0; i < positions.size(); i++) {
+        engine.clear(); // every position starts cold so the count does not depend on the order
+        engine.newSearch();
+        timer.start();
+        SearchResult r = engine.search(positions[i], limits);
+        timer.stop();
+        totalNodes += r.nodes;
+        totalNs += timer.getNanoseconds();
+        if (!print) continue;
+        char line[160];
+        snprintf(line, sizeof(line), "  %2zu  %-6s %12llu nodes %8lld ms\n", i + 1,
+                 r.bestMove.isNone() ? "none" : moveToString(r.bestMove).c_str(), (unsigned long long)r.nodes, timer.getMilliseconds());
+        cout << line;
+    }
+}
+
+// Time to depth for 1, 2, 4, 8 and 16 threads. With Lazy SMP the helpers search too, so nodes and nps
+// grow with the threads; the speedup that matters is how much sooner the main thread reaches the depth.
+static void runScaling(const vector<Position>& positions, const SearchLimits& limits, size_t hashMegabytes) {
+    cout << "threads      time ms        nodes          nps  speedup\n";
+    long long baseNs = 0;
+    for (int threads = 1; threads <= 16; threads *= 2) {
+        Engine engine(hashMegabytes);
+        engine.options.threads = threads;
+        uint64_t nodes;
+        long long ns;
+        searchPositions(engine, positions, limits, false, nodes, ns);
+        if (threads == 1) baseNs = ns;
+        long long ms = max(1LL, ns / 1000000);
+        char line[160];
+        snprintf(line, sizeof(line), "%7d %12lld %12llu %12llu %8.2f\n", threads, ms, (unsigned long long)nodes,
+                 (unsigned long long)(nodes * 1000 / ms), double(baseNs) / double(max(1LL, ns)));
+        cout << line << flush;
+    }
+}
+
+int benchCommand(int argc, char* argv[]) {
+    int depth = 8;
+    int threads = 1; // helper threads share the hash table and change the node count
+    size_t hashMegabytes = 16;
+    bool scaling = false;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--depth" && i + 1 < argc) {
+            depth = max(1, stoi(argv[++i]));
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = max(1, stoi(argv[++i]));
+        } else if (arg == "--hash" && i + 1 < argc) {
+            hashMegabytes = stoul(argv[++i]);
+        } else if (arg == "--scaling") {
+            scaling = true;
+        } else if (arg == "--nnue" && i + 1 < argc) {
+            nnueEnabled = nnueLoad(argv[++i]);
+            if (!nnueEnabled) {
+                cout << "Cannot load network " << argv[i] << "\n";
+                return 1;
+            }
+        } else {
+            cout << "usage: chess bench [--depth N] [--threads N | --scaling] [--hash MB] [--nnue file]\n";
+            return 1;
+        }
+    }
+
+    initBitboards();
+    vector<Position> positions = loadPositions();
+    SearchLimits limits;
+    limits.depth = depth;
+    if (scaling) {
+        cout << "Search to depth " << depth << ", " << hashMegabytes << " MB hash, " << thread::hardware_concurrency() << " cores\n";
+        runScaling(positions, limits, hashMegabytes);
+        return 0;
+    }
+    Engine engine(hashMegabytes);
+    engine.options.threads = threads;
+
+    cout << "Search to depth " << depth << ", " << threads << " thread" << (threads > 1 ? "s" : "") << ", "
+         << hashMegabytes << " MB hash, " << (nnueEnabled ? string("nnue ") + nnueKernel() : string("classic")) << " evaluation\n";
+    uint64_t totalNodes;
+    long long totalNs;
+    searchPositions(engine, positions, limits, true, totalNodes, totalNs);
+    long long ms = max(1LL, totalNs / 1000000);
+    cout << "\nNodes searched  : " << totalNodes << "\n";
+    cout << "Time (ms)       : " << ms << "\n";
+    cout << "Nodes/second    : " << totalNodes * 1000 / ms << "\n";
+
+    runMicrobenchmarks(positions, 200000);
+    return 0;
+}
@@ -0,0 +1,14 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+// Reproducible performance check. Searches a fixed set of positions to a fixed depth from a cold
+// hash table and prints the total node count, which only changes when the search itself changes,
+// followed by nps and microbenchmarks of move generation, evaluation and make/unmake. --scaling
+// instead measures time to depth with 1, 2, 4, 8 and 16 threads.
+// chess bench [--depth N] [--threads N | --scaling] [--hash MB] [--nnue file]
+int benchCommand(int argc, char* argv[]);
@@ -0,0 +1,162 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include <mutex>
+#include "bitboard.h"
+
+using namespace std;
+
+Bitboard knightAttackTable[64];
+Bitboard kingAttackTable[64];
+Bitboard pawnAttackTable[2][64];
+Magic bishopMagics[64];
+Magic rookMagics[64];
+Bitboard betweenTable[64][64];
+Bitboard lineTable[64][64];
+
+static Bitboard bishopTable[0x1480]; // 5248 entries shared by all bishop squares
+static Bitboard rookTable[0x19000];  // 102400 entries shared by all rook squares
+
+static Bitboard slidingAttacks(int sq, Bitboard occupied, const int directions[4][2]) { // slow ray walk, init only
+    Bitboard attacks = 0;
+    for (int i = 0; i < 4; i++) {
+        int r = rankOf(sq) + directions[i][0];
+        int f = fileOf(sq) + directions[i][1];
+        while (r >= 0 && r < 8 && f >= 0 && f < 8) { // keep moving until edge of board or blocked
+            attacks |= squareBit(makeSquare(r, f));
+            if (occupied & squareBit(makeSquare(r, f))) break;
+            r += directions[i][0];
+            f += directions[i][1];
+        }
+    }
+    return attacks;
+}
+
+#ifndef USE_PEXT
+static uint64_t randomState = 0x9E3779B97F4A7C15ULL;
+
+static uint64_t nextRandom() { // xorshift64*, fixed seed so magics are the same every run
+    randomState ^= randomState >> 12;
+    randomState ^= randomState << 25;
+    randomState ^= randomState >> 27;
+    return randomState * 2685821657736338717ULL;
+}
+#endif
+
+static void initMagics(Magic magics[64], Bitboard* table, const int directions[4][2]) {
+    Bitboard reference[4096];
+#ifndef USE_PEXT
+    Bitboard occupancy[4096];
+    int epoch[4096] = {0};
+    int attempt = 0;
+#endif
+    Bitboard* next = table;
+
+    for (int sq = 0; sq < 64; sq++) {
+        Magic& m = magics[sq];
+        // board edges are never relevant blockers, unless the slider is on that edge itself
+        Bitboard edges = ((RANK_1 | RANK_8) & ~(RANK_1 << (8 * rankOf(sq))))
+                       | ((FILE_A | FILE_H) & ~(FILE_A << fileOf(sq)));
+        m.mask = slidingAttacks(sq, 0, directions) & ~edges;
+        m.shift = 64 - popCount(m.mask);
+        m.attacks = next;
+
+        int size = 0; // enumerate every subset of the mask (carry-rippler)
+        Bitboard b = 0;
+        do {
+            reference[size] = slidingAttacks(sq, b, directions);
+#ifdef USE_PEXT
+            m.attacks[_pext_u64(b, m.mask)] = reference[size];
+#else
+            occupancy[size] = b;
+#endif
+            size++;
+            b = (b - m.mask) & m.mask;
+        } while (b);
+        next += size;
+
+#ifndef USE_PEXT
+        // search for a magic that maps every subset to a slot without destructive collisions
+        for (int i = 0; i < size; ) {
+            m.magic = 0;
+            while (popCount((m.magic * m.mask) >> 56) < 6) {
+                m.magic = nextRandom() & nextRandom() & nextRandom(); // sparse candidates work best
+            }
+            attempt++;
+            for (i = 0; i < size; i++) {
+                unsigned idx = m.index(occupancy[i]);
+                if (epoch[idx] < attempt) {
+                    epoch[idx] = attempt;
+                    m.attacks[idx] = reference[i];
+                } else if (m.attacks[idx] != reference[i]) {
+                    break;
+                }
+            }
+        }
+#endif
+    }
+}
+
+static void buildTables() {
+    int knightMoves[8][2] = {{2, -1}, {2, 1}, {-2, -1}, {-2, 1}, {1, -2}, {1, 2}, {-1, -2}, {-1, 2}}; // knight move patterns
+    int kingDirections[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}}; // king move directions
+
+    for (int sq = 0; sq < 64; sq++) {
+        int r = rankOf(sq);
+        int f = fileOf(sq);
+        knightAttackTable[sq] = 0;
+        kingAttackTable[sq] = 0;
+        for (int i = 0; i < 8; i++) {
+            int tr = r + knightMoves[i][0];
+            int tf = f + knightMoves[i][1];
+            if (tr >= 0 && tr < 8 && tf >= 0 && tf < 8) knightAttackTable[sq] |= squareBit(makeSquare(tr, tf));
+            tr = r + kingDirections[i][0];
+            tf = f + kingDirections[i][1];
+            if (tr >= 0 && tr < 8 && tf >= 0 && tf < 8) kingAttackTable[sq] |= squareBit(makeSquare(tr, tf));
+        }
+        pawnAttackTable[0][sq] = shiftNorthEast(squareBit(sq)) | shiftNorthWest(squareBit(sq));
+        pawnAttackTable[1][sq] = shiftSouthEast(squareBit(sq)) | shiftSouthWest(squareBit(sq));
+    }
+
+    int bishopDirections[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}}; // bishop move directions
+    int rookDirections[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};    // rook move directions
+    initMagics(bishopMagics, bishopTable, bishopDirections);
+    initMagics(rookMagics, rookTable, rookDirections);
+
+    for (int a = 0; a < 64; a++) {
+        for (int b = 0; b < 64; b++) {
+            betweenTable[a][b] = lineTable[a][b] = 0;
+            if (a == b) continue;
+            if (bishopAttacks(a, 0) & squareBit(b)) {
+                betweenTable[a][b] = bishopAttacks(a, squareBit(b)) & bishopAttacks(b, squareBit(a));
+                lineTable[a][b] = (bishopAttacks(a, 0) & bishopAttacks(b, 0)) | squareBit(a) | squareBit(b);
+            } else if (rookAttacks(a, 0) & squareBit(b)) {
+                betweenTable[a][b] = rookAttacks(a, squareBit(b)) & rookAttacks(b, squareBit(a));
+                lineTable[a][b] = (rookAttacks(a, 0) & rookAttacks(b, 0)) | squareBit(a) | squareBit(b);
+            }
+        }
+    }
+}
+
+void initBitboards() { // any number of threads may call it, the first one builds the tables
+    static once_flag built;
+    call_once(built, buildTables);
+}
+
+string squareName(int sq) {
+    return string(1, char('a' + fileOf(sq))) + string(1, char('1' + rankOf(sq)));
+}
+
+string bitboardString(Bitboard b) {
+    string s;
+    for (int r = 7; r >= 0; r--) {
+        for (int f = 0; f < 8; f++) {
+            s += (b & squareBit(makeSquare(r, f))) ? "X " : ". ";
+        }
+        s += "\n";
+    }
+    return s;
+}
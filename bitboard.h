@@ -0,0 +1,103 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#if defined(__BMI2__) && !defined(NO_PEXT)
+#include <immintrin.h>
+#define USE_PEXT // pext slider lookups when the target has BMI2, magic multiplication otherwise
+#endif
+
+typedef uint64_t Bitboard;
+
+// squares are numbered a1 = 0, b1 = 1 ... h8 = 63
+enum Square {
+    A1, B1, C1, D1, E1, F1, G1, H1,
+    A2, B2, C2, D2, E2, F2, G2, H2,
+    A3, B3, C3, D3, E3, F3, G3, H3,
+    A4, B4, C4, D4, E4, F4, G4, H4,
+    A5, B5, C5, D5, E5, F5, G5, H5,
+    A6, B6, C6, D6, E6, F6, G6, H6,
+    A7, B7, C7, D7, E7, F7, G7, H7,
+    A8, B8, C8, D8, E8, F8, G8, H8,
+    NO_SQUARE
+};
+
+const Bitboard FILE_A = 0x0101010101010101ULL;
+const Bitboard FILE_H = FILE_A << 7;
+const Bitboard RANK_1 = 0xFFULL;
+const Bitboard RANK_2 = RANK_1 << 8;
+const Bitboard RANK_3 = RANK_1 << 16;
+const Bitboard RANK_4 = RANK_1 << 24;
+const Bitboard RANK_5 = RANK_1 << 32;
+const Bitboard RANK_6 = RANK_1 << 40;
+const Bitboard RANK_7 = RANK_1 << 48;
+const Bitboard RANK_8 = RANK_1 << 56;
+const Bitboard CENTER = 0x0000001818000000ULL;     // d4 e4 d5 e5
+const Bitboard BIG_CENTER = 0x00003C3C3C3C0000ULL; // c3 - f6
+
+inline Bitboard squareBit(int sq) { return 1ULL << sq; }
+inline int rankOf(int sq) { return sq >> 3; }
+inline int fileOf(int sq) { return sq & 7; }
+inline int makeSquare(int rank, int file) { return rank * 8 + file; }
+
+inline int popCount(Bitboard b) { return __builtin_popcountll(b); }
+inline int lsb(Bitboard b) { return __builtin_ctzll(b); }
+inline int msb(Bitboard b) { return 63 - __builtin_clzll(b); }
+inline int popLsb(Bitboard& b) { // return and clear the lowest set square
+    int sq = lsb(b);
+    b &= b - 1;
+    return sq;
+}
+inline bool moreThanOne(Bitboard b) { return b & (b - 1); }
+
+inline Bitboard shiftNorth(Bitboard b) { return b << 8; }
+inline Bitboard shiftSouth(Bitboard b) { return b >> 8; }
+inline Bitboard shiftNorthEast(Bitboard b) { return (b & ~FILE_H) << 9; }
+inline Bitboard shiftNorthWest(Bitboard b) { return (b & ~FILE_A) << 7; }
+inline Bitboard shiftSouthEast(Bitboard b) { return (b & ~FILE_H) >> 7; }
+inline Bitboard shiftSouthWest(Bitboard b) { return (b & ~FILE_A) >> 9; }
+
+struct Magic { // per-square slider lookup, see initBitboards()
+    Bitboard mask;
+    Bitboard magic;
+    Bitboard* attacks;
+    int shift;
+
+    unsigned index(Bitboard occupied) const {
+#ifdef USE_PEXT
+        return unsigned(_pext_u64(occupied, mask));
+#else
+        return unsigned(((occupied & mask) * magic) >> shift);
+#endif
+    }
+};
+
+extern Bitboard knightAttackTable[64];
+extern Bitboard kingAttackTable[64];
+extern Bitboard pawnAttackTable[2][64]; // [color][square], white = 0
+extern Magic bishopMagics[64];
+extern Magic rookMagics[64];
+extern Bitboard betweenTable[64][64]; // squares strictly between two aligned squares, empty otherwise
+extern Bitboard lineTable[64][64];    // whole rank, file or diagonal through two aligned squares, empty otherwise
+
+void initBitboards(); // before any attack lookup; later and concurrent calls wait for the first to finish
+
+inline Bitboard bishopAttacks(int sq, Bitboard occupied) {
+    return bishopMagics[sq].attacks[bishopMagics[sq].index(occupied)];
+}
+inline Bitboard rookAttacks(int sq, Bitboard occupied) {
+    return rookMagics[sq].attacks[rookMagics[sq].index(occupied)];
+}
+inline Bitboard queenAttacks(int sq, Bitboard occupied) {
+    return bishopAttacks(sq, occupied) | rookAttacks(sq, occupied);
+}
+
+std::string squareName(int sq); // "e4" style name of a square
+std::string bitboardString(Bitboard b); // 8x8 dump for debugging
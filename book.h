@@ -0,0 +1,42 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include "move.h"
+#include "position.h"
+
+// Polyglot keys, from the 781 Random64 constants of the Polyglot book format, built in.
+uint64_t polyglotKey(const Position& pos);
+bool polyglotSelfTest(); // the published reference keys, starting with 0x463B96181691FC9C for the start position
+
+// Read-only Polyglot .bin book. The file is memory-mapped, so opening costs the same for any size
+// and only the pages a lookup touches are ever read.
+class OpeningBook {
+    public:
+        OpeningBook() {}
+        ~OpeningBook() { close(); }
+        OpeningBook(const OpeningBook&) = delete;
+        OpeningBook& operator=(const OpeningBook&) = delete;
+
+        bool open(const std::string& path); // false if the file is unusable
+        void close();
+        bool isOpen() const { return count > 0; }
+        size_t size() const { return count; } // entries
+
+        Move probe(const Position& pos); // legal book move chosen by weight, none when out of book
+
+    private:
+        const unsigned char* data = nullptr;
+        size_t bytes = 0;
+        size_t count = 0;
+        bool mapped = false;
+        std::mt19937_64 rng{std::random_device{}()};
+};
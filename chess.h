@@ -0,0 +1,35 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+// The engine as a library (libchesscore.a). Call initBitboards() once, or from every thread that
+// may be first; after that the lookup tables are read-only. All game state lives in Position and
+// all search state in Engine, so any number of either can exist side by side: a Position per game,
+// an Engine per concurrent search (each search blocks its caller, use stop() from another thread).
+// Process-wide settings are the network (nnueLoad, nnueEnabled) and the tablebases (tbInit); set
+// them up before searching.
+//
+//     initBitboards();
+//     Position pos;
+//     pos.setFromFen(START_FEN);
+//     Engine engine(16);
+//     SearchLimits limits;
+//     limits.movetime = 100;
+//     engine.newSearch();
+//     SearchResult r = engine.search(pos, limits);
+//     UndoInfo undo;
+//     pos.makeMove(r.bestMove, undo);
+
+#include "bitboard.h"
+#include "book.h"
+#include "evaluate.h"
+#include "movegen.h"
+#include "nnue.h"
+#include "position.h"
+#include "search.h"
+#include "tablebase.h"
+#include "uci.h"
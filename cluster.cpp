@@ -0,0 +1,584 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "bitboard.h"
+#include "cluster.h"
+#include "movegen.h"
+#include "nnue.h"
+#include "search.h"
+#include "timer.h"
+#include "uci.h"
+
+using namespace std;
+
+// Coordinator and workers talk in lines:
+//     share <depth>                              pass on hash entries at least this deep, 0 for none
+//     position <fen>                             the root of the following searches, ages the hash table
+//     search <id> <move> <depth> <alpha> <beta>  one root move, window from the root side's point of view
+//     tt <key> <move> <score> <depth> <bound>    a raw hash table entry, sent both ways
+//     stop, quit
+// and every search is answered with
+//     result <id> <complete 0|1> <score> <nodes> <pv ...>
+
+static bool sendLine(int fd, const string& line) { // blocking
+    string data = line + "\n";
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += size_t(n);
+    }
+    return true;
+}
+
+static bool takeLine(string& input, string& line) { // the first complete line of input, if any
+    size_t end = input.find('\n');
+    if (end == string::npos) return false;
+    line = input.substr(0, end);
+    input.erase(0, end + 1);
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    return true;
+}
+
+static bool readLine(int fd, string& input, string& line) { // blocking, false once the connection closes
+    char buffer[4096];
+    while (!takeLine(input, line)) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) return false;
+        input.append(buffer, size_t(n));
+    }
+    return true;
+}
+
+// ---- worker ----
+
+static void noDelay(int fd) { // searches are short, a line held back for batching costs more than it saves
+    int on = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+}
+
+static int connectTo(const string& address) { // host:port, retried for a while so workers may start first
+    size_t colon = address.rfind(':');
+    if (colon == string::npos) return -1;
+    string host = address.substr(0, colon), port = address.substr(colon + 1);
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    for (int attempt = 0; attempt < 100; attempt++) {
+        addrinfo* found;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &found) == 0) {
+            for (addrinfo* a = found; a; a = a->ai_next) {
+                int fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+                if (fd < 0) continue;
+                if (connect(fd, a->ai_addr, a->ai_addrlen) == 0) {
+                    noDelay(fd);
+                    freeaddrinfo(found);
+                    return fd;
+                }
+                close(fd);
+            }
+            freeaddrinfo(found);
+        }
+        this_thread::sleep_for(chrono::milliseconds(100));
+    }
+    return -1;
+}
+
+static void shareLine(int fd, const Engine& engine, const Position& root, const SearchResult& r, int shareDepth) {
+    Position pos = root;
+    for (int i = 0; i < r.pvLength; i++) {
+        UndoInfo undo;
+        pos.makeMove(r.pv[i], undo);
+        TTEntry entry;
+        if (!engine.tt.probe(pos.key, entry) || entry.depth < shareDepth) break; // later positions are shallower still
+        ostringstream out;
+        out << "tt " << pos.key << " " << entry.move.raw() << " " << entry.score << " " << entry.depth << " " << entry.bound;
+        sendLine(fd, out.str());
+    }
+}
+
+static int workerCommand(int argc, char* argv[]) {
+    string address;
+    size_t hashMegabytes = 16;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--connect" && i + 1 < argc) {
+            address = argv[++i];
+        } else if (arg == "--hash" && i + 1 < argc) {
+            hashMegabytes = stoul(argv[++i]);
+        } else if (arg == "--nnue" && i + 1 < argc) {
+            nnueEnabled = nnueLoad(argv[++i]);
+            if (!nnueEnabled) cerr << "cannot load network " << argv[i] << "\n";
+        } else {
+            address.clear();
+            break;
+        }
+    }
+    if (address.empty()) {
+        cerr << "usage: chess cluster worker --connect host:port [--hash MB] [--nnue file]\n";
+        return 1;
+    }
+
+    initBitboards();
+    int fd = connectTo(address);
+    if (fd < 0) {
+        cerr << "cannot connect to " << address << "\n";
+        return 1;
+    }
+    Engine engine(hashMegabytes);
+    engine.options.threads = 1; // more processes are the parallelism
+    Position root;
+    root.setStartPosition();
+    int shareDepth = 0;
+    thread searcher; // the coordinator sends nothing but stop and tt while a search runs
+
+    // Commands are read here so stop and incoming hash entries take effect mid-search.
+    string input, line;
+    while (readLine(fd, input, line)) {
+        istringstream in(line);
+        string command;
+        in >> command;
+        if (command == "search") {
+            int id, depth, alpha, beta;
+            string lan;
+            in >> id >> lan >> depth >> alpha >> beta;
+            Move m = parseMove(root, lan);
+            if (searcher.joinable()) searcher.join();
+            engine.newSearch(); // before the searcher exists, so a stop read after this line reaches it
+            searcher = thread([&, id, m, depth, alpha, beta] {
+                SearchResult r;
+                bool complete = !m.isNone() && engine.searchMove(root, m, depth, alpha, beta, r);
+                if (complete && shareDepth > 0) shareLine(fd, engine, root, r, shareDepth);
+                ostringstream out;
+                out << "result " << id << " " << complete << " " << (root.sideToMove == WHITE ? r.score : -r.score) << " " << r.nodes;
+                for (int i = 0; i < r.pvLength; i++) out << " " << moveToString(r.pv[i]);
+                sendLine(fd, out.str());
+            });
+        } else if (command == "tt") {
+            uint64_t key;
+            int raw, score, depth, bound;
+            if (in >> key >> raw >> score >> depth >> bound) engine.tt.store(key, Move::fromRaw(uint16_t(raw)), score, depth, bound);
+        } else if (command == "position") {
+            if (searcher.joinable()) searcher.join();
+            string fen;
+            getline(in >> ws, fen);
+            if (!root.setFromFen(fen)) root.setStartPosition();
+            engine.tt.newSearch();
+        } else if (command == "share") {
+            in >> shareDepth;
+        } else if (command == "stop") {
+            engine.stop();
+        } else if (command == "quit") {
+            break;
+        }
+    }
+    engine.stop();
+    if (searcher.joinable()) searcher.join();
+    close(fd);
+    return 0;
+}
+
+// ---- coordinator ----
+
+enum TaskKind { FULL_WINDOW, SCOUT, RESEARCH };
+
+struct Task {
+    int index; // into the root moves
+    TaskKind kind;
+    int alpha = 0; // the bound it was searched against, set by assign
+};
+
+struct WorkerLink { // one connected worker
+    int fd;          // non-blocking, -1 once lost
+    string input;    // received bytes not yet ending in a newline
+    string output;   // lines the socket did not take yet, sent as it drains
+    int jobId = -1;  // search running there, -1 when idle
+    Task task = {0, FULL_WINDOW};
+    uint64_t nodes = 0;
+    int searches = 0;
+};
+
+struct JobResult {
+    int worker;
+    Task task;
+    bool complete = false; // false when stopped or the worker was lost
+    RootLine line;         // score from the root side's point of view
+};
+
+struct Cluster {
+    vector<WorkerLink> workers;
+    Position root;
+    Timer timer;
+    long long movetime = 0; // ms, 0 for none
+    uint64_t nodes = 0;     // all workers, every search
+    uint64_t sharedEntries = 0;
+    int nextJobId = 0;
+};
+
+// Sends what the socket takes without waiting. Coordinator and workers both write while the other
+// is busy, so a blocking send on either side could leave both waiting for the other to read.
+static void flushOutput(WorkerLink& w) {
+    size_t sent = 0;
+    while (w.fd >= 0 && sent < w.output.size()) {
+        ssize_t n = send(w.fd, w.output.data() + sent, w.output.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break; // full, or broken and nextResult notices when it reads
+        sent += size_t(n);
+    }
+    w.output.erase(0, sent);
+}
+
+static void queueLine(WorkerLink& w, const string& line) { // nextResult sends what does not go out at once
+    if (w.fd < 0) return;
+    bool queued = !w.output.empty();
+    w.output += line + "\n";
+    if (!queued) flushOutput(w);
+}
+
+static void assign(Cluster& c, WorkerLink& w, const Task& task, Move m, int depth, int alpha) {
+    int lower = task.kind == FULL_WINDOW ? -INFINITE_SCORE : alpha;
+    int upper = task.kind == SCOUT ? alpha + 1 : INFINITE_SCORE;
+    w.jobId = c.nextJobId++;
+    w.task = task;
+    w.task.alpha = alpha;
+    w.searches++;
+    queueLine(w, "search " + to_string(w.jobId) + " " + moveToString(m) + " " + to_string(depth) + " "
+                   + to_string(lower) + " " + to_string(upper));
+}
+
+static bool handleWorkerLine(Cluster& c, int worker, const string& line, JobResult& r) { // true for a result of the running job
+    WorkerLink& w = c.workers[worker];
+    istringstream in(line);
+    string command;
+    in >> command;
+    if (command == "tt") { // pass it on to everybody else
+        for (size_t i = 0; i < c.workers.size(); i++) {
+            if (int(i) != worker) queueLine(c.workers[i], line);
+        }
+        c.sharedEntries++;
+        return false;
+    }
+    int id, complete, score;
+    uint64_t nodes;
+    if (command != "result" || !(in >> id >> complete >> score >> nodes)) return false;
+    w.nodes += nodes;
+    c.nodes += nodes;
+    if (id != w.jobId) return false; // answer to a search already given up on
+    r = JobResult();
+    r.worker = worker;
+    r.task = w.task;
+    r.complete = complete != 0;
+    r.line.score = score;
+    Position pos = c.root;
+    string lan;
+    while (r.line.pvLength < MAX_PLY && in >> lan) {
+        Move m = parseMove(pos, lan);
+        if (m.isNone()) break;
+        UndoInfo undo;
+        pos.makeMove(m, undo);
+        r.line.pv[r.line.pvLength++] = m;
+    }
+    w.jobId = -1;
+    return true;
+}
+
+// Waits for the next finished (or lost) search. False if the movetime ran out first.
+static bool nextResult(Cluster& c, JobResult& r, bool useDeadline) {
+    char buffer[4096];
+    string line;
+    while (true) {
+        for (size_t i = 0; i < c.workers.size(); i++) { // lines already received
+            while (c.workers[i].fd >= 0 && takeLine(c.workers[i].input, line)) {
+                if (handleWorkerLine(c, int(i), line, r)) return true;
+            }
+        }
+        vector<pollfd> fds;
+        vector<int> owners;
+        for (size_t i = 0; i < c.workers.size(); i++) {
+            if (c.workers[i].fd < 0) continue;
+            fds.push_back({c.workers[i].fd, short(POLLIN | (c.workers[i].output.empty() ? 0 : POLLOUT)), 0});
+            owners.push_back(int(i));
+        }
+        int timeout = -1;
+        if (useDeadline && c.movetime > 0) {
+            long long left = c.movetime - c.timer.elapsedMilliseconds();
+            if (left <= 0) return false;
+            timeout = int(left);
+        }
+        int ready = poll(fds.data(), fds.size(), timeout);
+        if (ready < 0 && errno != EINTR) return false;
+        if (ready == 0) return false; // timed out
+        for (size_t k = 0; k < fds.size(); k++) {
+            if (!fds[k].revents) continue;
+            WorkerLink& w = c.workers[owners[k]];
+            if (fds[k].revents & POLLOUT) flushOutput(w);
+            if (!(fds[k].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            ssize_t n = recv(w.fd, buffer, sizeof(buffer), 0);
+            if (n > 0) {
+                w.input.append(buffer, size_t(n));
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) continue;
+            cerr << "lost worker " << owners[k] << "\n";
+            close(w.fd);
+            w.fd = -1;
+            w.output.clear();
+            if (w.jobId >= 0) { // its search goes back in the queue
+                r = JobResult();
+                r.worker = owners[k];
+                r.task = w.task;
+                w.jobId = -1;
+                return true;
+            }
+        }
+    }
+}
+
+static void stopAll(Cluster& c) { // and wait for the stopped searches to answer
+    for (WorkerLink& w : c.workers) {
+        if (w.jobId >= 0) queueLine(w, "stop");
+    }
+    JobResult r;
+    while (any_of(c.workers.begin(), c.workers.end(), [](const WorkerLink& w) { return w.fd >= 0 && w.jobId >= 0; })) {
+        if (!nextResult(c, r, false)) break;
+    }
+}
+
+// One iteration over the root moves, best first. best is set once the first move has its score, even
+// if the time runs out later; scores gets every score or bound learned, to order the next iteration.
+// False if the iteration did not finish.
+static bool searchIteration(Cluster& c, const vector<Move>& moves, int depth, RootLine& best, vector<int>& scores) {
+    deque<Task> tasks = {{0, FULL_WINDOW}};
+    int alpha = -INFINITE_SCORE;
+    int running = 0;
+    best.pvLength = 0;
+    while (true) {
+        for (WorkerLink& w : c.workers) {
+            if (tasks.empty()) break;
+            if (w.fd < 0 || w.jobId >= 0) continue;
+            assign(c, w, tasks.front(), moves[tasks.front().index], depth, alpha);
+            tasks.pop_front();
+            running++;
+        }
+        if (!running) {
+            if (tasks.empty()) return true;
+            cerr << "no workers left\n";
+            return false;
+        }
+        JobResult r;
+        if (!nextResult(c, r, true)) {
+            stopAll(c);
+            return false;
+        }
+        running--;
+        if (!r.complete) { // lost with its worker, try again elsewhere
+            tasks.push_front(r.task);
+            continue;
+        }
+        scores[r.task.index] = r.line.score;
+        if (r.task.kind == FULL_WINDOW) {
+            best = r.line;
+            alpha = best.score;
+            for (int i = 1; i < int(moves.size()); i++) tasks.push_back({i, SCOUT});
+        } else if (r.task.kind == SCOUT) {
+            if (r.line.score > alpha) {
+                tasks.push_front({r.task.index, RESEARCH});
+            } else if (r.line.score > r.task.alpha) { // a lower bound under the raised alpha, the move may still beat it
+                tasks.push_back({r.task.index, SCOUT});
+            }
+        } else if (r.line.score > alpha) { // an exact score, unless the best was raised past it meanwhile
+            best = r.line;
+            alpha = best.score;
+        }
+    }
+}
+
+static int openListener(const string& host, int& port) { // port 0 picks a free one and returns it
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(uint16_t(port));
+    if (inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) return -1;
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int on = 1;
+    if (fd >= 0) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (fd < 0 || bind(fd, (sockaddr*)&address, sizeof(address)) < 0 || listen(fd, 64) < 0) return -1;
+    socklen_t length = sizeof(address);
+    getsockname(fd, (sockaddr*)&address, &length);
+    port = ntohs(address.sin_port);
+    return fd;
+}
+
+static pid_t spawnWorker(int port, size_t hashMegabytes, const string& nnuePath) { // this binary, over loopback
+    string address = "127.0.0.1:" + to_string(port), hash = to_string(hashMegabytes);
+    vector<const char*> args = {"chess", "cluster", "worker", "--connect", address.c_str(), "--hash", hash.c_str()};
+    if (!nnuePath.empty()) {
+        args.push_back("--nnue");
+        args.push_back(nnuePath.c_str());
+    }
+    args.push_back(nullptr);
+    pid_t pid = fork();
+    if (pid == 0) {
+        execv("/proc/self/exe", (char* const*)args.data());
+        _exit(127);
+    }
+    return pid;
+}
+
+int clusterCommand(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "worker") return workerCommand(argc - 1, argv + 1);
+
+    string fen = START_FEN, host = "127.0.0.1", nnuePath;
+    int depth = 0, spawn = 0, expected = -1, port = 0, shareDepth = 6;
+    long long movetime = 0;
+    size_t hashMegabytes = 16;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--fen" && i + 1 < argc) {
+            fen = argv[++i];
+        } else if (arg == "--depth" && i + 1 < argc) {
+            depth = max(1, stoi(argv[++i]));
+        } else if (arg == "--movetime" && i + 1 < argc) {
+            movetime = max(1LL, stoll(argv[++i]));
+        } else if (arg == "--spawn" && i + 1 < argc) {
+            spawn = max(0, stoi(argv[++i]));
+        } else if (arg == "--workers" && i + 1 < argc) {
+            expected = max(1, stoi(argv[++i]));
+        } else if (arg == "--host" && i + 1 < argc) {
+            host = argv[++i];
+        } else if (arg == "--port" && i + 1 < argc) {
+            port = stoi(argv[++i]);
+        } else if (arg == "--hash" && i + 1 < argc) {
+            hashMegabytes = stoul(argv[++i]);
+        } else if (arg == "--share-depth" && i + 1 < argc) { // 0 shares nothing
+            shareDepth = max(0, stoi(argv[++i]));
+        } else if (arg == "--nnue" && i + 1 < argc) {
+            nnuePath = argv[++i];
+        } else {
+            cerr << "usage: chess cluster [--fen FEN] [--depth N] [--movetime ms] [--spawn N] [--workers N] [--host address]\n"
+                    "                     [--port N] [--hash MB] [--share-depth N] [--nnue file]\n"
+                    "       chess cluster worker --connect host:port [--hash MB] [--nnue file]\n";
+            return 1;
+        }
+    }
+    if (expected < 0) expected = spawn;
+    if (expected < 1) {
+        cerr << "no workers: use --spawn or --workers\n";
+        return 1;
+    }
+    if (depth == 0 && movetime == 0) depth = 8;
+
+    initBitboards();
+    Cluster c;
+    if (!c.root.setFromFen(fen)) {
+        cerr << "invalid FEN: " << fen << "\n";
+        return 1;
+    }
+    int listener = openListener(host, port);
+    if (listener < 0) {
+        cerr << "cannot listen on " << host << ":" << port << ": " << strerror(errno) << "\n";
+        return 1;
+    }
+    cout << "listening on " << host << ":" << port << ", waiting for " << expected << " workers" << endl;
+    vector<pid_t> children;
+    for (int i = 0; i < spawn; i++) children.push_back(spawnWorker(port, hashMegabytes, nnuePath));
+
+    Timer waiting;
+    waiting.start();
+    while (int(c.workers.size()) < expected && waiting.elapsedMilliseconds() < 30000) {
+        pollfd p = {listener, POLLIN, 0};
+        if (poll(&p, 1, 1000) <= 0) continue;
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0) continue;
+        noDelay(fd);
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        WorkerLink w;
+        w.fd = fd;
+        c.workers.push_back(w);
+    }
+    close(listener);
+    int status = 0;
+    if (int(c.workers.size()) < expected) {
+        cerr << "only " << c.workers.size() << " of " << expected << " workers connected\n";
+        status = 1;
+    }
+
+    MoveList legal;
+    enumerateAllMoves(c.root, legal);
+    vector<Move> moves(legal.begin(), legal.begin() + legal.size());
+    if (status == 0 && moves.empty()) {
+        cout << "bestmove 0000" << endl;
+    } else if (status == 0) {
+        for (WorkerLink& w : c.workers) {
+            queueLine(w, "share " + to_string(shareDepth));
+            queueLine(w, "position " + c.root.fen());
+        }
+        c.movetime = movetime;
+        c.timer.start();
+        RootLine best;
+        best.pv[0] = moves[0];
+        best.pvLength = 1;
+        int maxDepth = depth > 0 ? min(depth, MAX_PLY - 1) : MAX_PLY - 1;
+        for (int d = 1; d <= maxDepth; d++) {
+            // An iteration takes a few times longer than the one before it, don't start one that cannot finish.
+            if (movetime && d > 1 && c.timer.elapsedMilliseconds() * 2 >= movetime) break;
+            vector<int> scores(moves.size(), -INFINITE_SCORE);
+            RootLine line;
+            bool finished = searchIteration(c, moves, d, line, scores);
+            if (line.pvLength == 0) break; // not even the first move finished
+            best = line;
+
+            long long ms = max(1LL, c.timer.elapsedMilliseconds());
+            cout << "info depth " << d << " score " << scoreString(best.score) << " nodes " << c.nodes
+                 << " nps " << c.nodes * 1000 / uint64_t(ms) << " time " << ms << " pv";
+            for (int i = 0; i < best.pvLength; i++) cout << " " << moveToString(best.pv[i]);
+            cout << endl;
+            if (!finished) break;
+            if (MATE_SCORE - abs(best.score) <= d) break; // cannot find a faster mate
+
+            // Next iteration: the best move first, then the others by what this one learned about them.
+            vector<pair<int, Move>> order;
+            for (size_t i = 0; i < moves.size(); i++) order.push_back({moves[i] == best.pv[0] ? INFINITE_SCORE : scores[i], moves[i]});
+            stable_sort(order.begin(), order.end(), [](const pair<int, Move>& a, const pair<int, Move>& b) { return a.first > b.first; });
+            for (size_t i = 0; i < moves.size(); i++) moves[i] = order[i].second;
+        }
+        cout << "bestmove " << moveToString(best.pv[0]);
+        if (best.pvLength > 1) cout << " ponder " << moveToString(best.pv[1]);
+        cout << endl;
+        long long ms = max(1LL, c.timer.elapsedMilliseconds());
+        for (size_t i = 0; i < c.workers.size(); i++) {
+            cout << "worker " << i << ": " << c.workers[i].nodes << " nodes in " << c.workers[i].searches << " searches\n";
+        }
+        cout << "total " << c.nodes << " nodes, " << c.nodes * 1000 / uint64_t(ms) << " nps, " << c.sharedEntries
+             << " hash entries shared" << endl;
+    }
+
+    for (WorkerLink& w : c.workers) { // every search has answered, so the workers only read now and waiting is safe
+        if (w.fd < 0) continue;
+        fcntl(w.fd, F_SETFL, 0);
+        sendLine(w.fd, w.output + "quit");
+        close(w.fd);
+    }
+    for (pid_t pid : children) waitpid(pid, nullptr, 0);
+    return status;
+}
@@ -0,0 +1,28 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+// Searches one position with several engine processes, on one machine or several. Workers connect
+// to the coordinator over TCP. The coordinator runs iterative deepening and splits every iteration
+// at the root, following the order Engine::searchRoot searches root moves in: the best move of the last
+// iteration is searched first with a full window, then the other root moves go one at a time to
+// whichever worker is free, with a null window against the best score so far, and only moves that
+// beat it are searched again with an open window. The bound travels with every assignment. A null
+// window result that beat its bound is only a lower bound, so if the best score has risen past it
+// meanwhile the move is searched again with a null window against the new best. Workers report the hash entries along each line they found that are at least the share
+// depth deep and the coordinator passes them on to every other worker. Each iteration prints the
+// score and line with the nodes and nps of all workers together.
+//
+// chess cluster [--fen FEN] [--depth N] [--movetime ms] [--spawn N] [--workers N] [--host address]
+//               [--port N] [--hash MB] [--share-depth N] [--nnue file]
+//     --spawn starts N workers on this machine over loopback. --workers is how many to wait for in
+//     all (default the spawned ones); the others are started, on any machine that reaches --host
+//     (default 127.0.0.1) and --port (default any free port, printed at startup), with
+// chess cluster worker --connect host:port [--hash MB] [--nnue file]
+// Without --depth or --movetime the search stops after depth 8. One search thread per worker, so
+// start one worker per core.
+int clusterCommand(int argc, char* argv[]);
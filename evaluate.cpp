@@ -0,0 +1,62 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include "evaluate.h"
+
+int pieceSquareValue[12][64];
+
+static struct EvaluationTablesInit {
+    EvaluationTablesInit() {
+        const int material[6] = {10, 30, 30, 50, 90, 100000};
+        for (int sq = 0; sq < 64; sq++) {
+            Bitboard b = squareBit(sq);
+            int rank = rankOf(sq);
+            for (int color = WHITE; color <= BLACK; color++) {
+                int relativeRank = color == WHITE ? rank : 7 - rank; // 0 = own back rank
+                for (int type = PAWN; type <= KING; type++) {
+                    int value = material[type]; // material evaluation
+
+                    // minor piece development
+                    if ((type == KNIGHT || type == BISHOP) && relativeRank >= 2) value += 2;
+
+                    // centralized knights
+                    if (type == KNIGHT && (b & BIG_CENTER)) value += 2;
+
+                    // advanced pawns
+                    if (type == PAWN && relativeRank >= 3) value += 1;
+
+                    // center control
+                    if (type == PAWN && (b & CENTER)) value += 5;
+
+                    pieceSquareValue[makePiece(color, type)][sq] = color == WHITE ? value : -value;
+                }
+            }
+        }
+    }
+} evaluationTablesInit;
+
+int pawnStructure(Bitboard wp, Bitboard bp) {
+    int evaluation = 0;
+
+    // defended pawns
+    evaluation += popCount(shiftSouthWest(wp) & wp) + popCount(shiftSouthEast(wp) & wp);
+    evaluation -= popCount(shiftNorthWest(bp) & bp) + popCount(shiftNorthEast(bp) & bp);
+
+    return evaluation;
+}
+
+int immediateEvaluation(const Position& pos, bool isOpening) {
+    int evaluation = pos.psqt + pos.pawnScore;
+
+    // bonus for castling
+    if (pos.castled[WHITE]) evaluation += 4;
+    if (pos.castled[BLACK]) evaluation -= 4;
+
+    if (isOpening) { // extra bonus for center control in opening
+        evaluation += 3 * (popCount(pos.pieces[W_PAWN] & CENTER) - popCount(pos.pieces[B_PAWN] & CENTER));
+    }
+    return evaluation;
+}
@@ -0,0 +1,19 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+#include "position.h"
+
+// Material and every term that depends on a single piece and its square live in
+// pieceSquareValue and are kept in Position::psqt by makeMove/unmakeMove. Terms that
+// depend on how pawns stand relative to each other live in pawnStructure() and are
+// only recomputed when a pawn moves, is captured or promotes.
+extern int pieceSquareValue[12][64];
+
+int pawnStructure(Bitboard whitePawns, Bitboard blackPawns);
+
+int immediateEvaluation(const Position& pos, bool isOpening = false); // static score, positive favors white
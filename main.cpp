@@ -4,582 +4,262 @@
  * (C) 2025 Tommy Ciccone All Rights Reserved.
 */
 
-#include <chrono>
 #include <iostream>
 #include <string>
-#include <vector>
 #include <thread>
-#include "omp.h" // Include OpenMP for parallel processing. Need to install omp to build.
+#include "batch.h"
+#include "bench.h"
+#include "bitboard.h"
+#include "book.h"
+#include "cluster.h"
+#include "match.h"
+#include "evaluate.h"
+#include "movegen.h"
+#include "nnue.h"
+#include "perft.h"
+#include "position.h"
+#include "search.h"
+#include "server.h"
+#include "tablebase.h"
+#include "timer.h"
+#include "tt.h"
+#include "uci.h"
 
 using namespace std;
 
-class Timer {
-    public:
-        void start() {
-            startTime = chrono::high_resolution_clock::now();
-        }
-        void stop() {
-            endTime = chrono::high_resolution_clock::now();
-        }
-        string getTime() {
-            return to_string(chrono::duration_cast<std::chrono::seconds>(endTime - startTime).count());
-        }
-    private:
-        chrono::high_resolution_clock::time_point startTime;
-        chrono::high_resolution_clock::time_point endTime;
-};
-
-int engineDepth = 5;
-int engineBranches = 10;
-
-bool whiteKingMoved = 0, blackKingMoved = 0, whiteLeftRookMoved = 0, 
-    whiteRightRookMoved = 0, blackLeftRookMoved = 0, blackRightRookMoved = 0;
-
-bool castled = false;
-
-int positionsEvaluated = 0;
-char board[8][8]; // 8x8 chess board
-
-void initializeBoard() { // place default pieces on board
-    string blackPieces = "rnbqkbnr";
-    string whitePieces = "RNBQKBNR";
-
-    for (int i = 0; i < 8; i++) {
-        board[0][i] = blackPieces[i];
-        board[1][i] = 'p';
-        board[6][i] = 'P';
-        board[7][i] = whitePieces[i];
-        for (int j = 2; j < 6; j++) {
-            board[j][i] = '.';
-        }
-    }
-}
-
-void printBoard() { // print board to console
+static void printBoard(const Position& board) { // print board to console
     cout << "\n";
     for (int i = 0; i < 8; i++) {
         cout << "\033[90m" << 8 - i << " \033[0m";  // rank
         for (int j = 0; j < 8; j++) {
-            cout << board[i][j] << ' ';             // piece
+            cout << pieceChars[board.pieceOn(makeSquare(7 - i, j))] << ' '; // piece
         }
         cout << "\n";
     }
     cout << "\033[90m  a b c d e f g h\n\n\033[0m"; // file
 }
 
-int immediateEvaluation(bool isOpening = false) {
-    int evaluation = 0;
-    bool whiteWins = true;
-    bool blackWins = true;
-    char piece;
-
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
-            piece = board[i][j];
-
-            switch (piece) { // material evaluation
-                case 'P': evaluation += 10; break;
-                case 'N': evaluation += 30; break;
-                case 'B': evaluation += 30; break;
-                case 'R': evaluation += 50; break;
-                case 'Q': evaluation += 90; break;
-                case 'K': evaluation += 100000; whiteWins = false; break;
-
-                case 'p': evaluation -= 10; break;
-                case 'n': evaluation -= 30; break;
-                case 'b': evaluation -= 30; break;
-                case 'r': evaluation -= 50; break;
-                case 'q': evaluation -= 90; break;
-                case 'k': evaluation -= 100000; blackWins = false; break;
-                default: break;
-            }
-
-            if (castled) {
-                evaluation -= 4; // bonus/penalty for castling (kept as original)
-            }
-
-            // minor piece development
-            if (piece == 'N' || piece == 'B') {
-                if (i < 6) evaluation += 2;
-            }
-            if (piece == 'n' || piece == 'b') {
-                if (i > 1) evaluation -= 2;
-            }
-
-            // centralized knights
-            if (piece == 'N' && (i >= 2 && i <= 5 && j >= 2 && j <= 5)) evaluation += 2;
-            if (piece == 'n' && (i >= 2 && i <= 5 && j >= 2 && j <= 5)) evaluation -= 2;
-
-            // defended pawns
-            if (piece == 'P' && i > 0) {
-                if (j > 0 && board[i-1][j-1] == 'P') evaluation += 1;
-                if (j < 7 && board[i-1][j+1] == 'P') evaluation += 1;
-            }
-            if (piece == 'p' && i < 7) {
-                if (j > 0 && board[i+1][j-1] == 'p') evaluation -= 1;
-                if (j < 7 && board[i+1][j+1] == 'p') evaluation -= 1;
-            }
-
-            // advanced pawns
-            if (piece == 'P' && i < 5) evaluation += 1;
-            if (piece == 'p' && i > 2) evaluation -= 1;
-
-            // center control
-            if (piece == 'P') {
-                if ((i == 3 || i == 4) && (j == 3 || j == 4)) {
-                    evaluation += 5;
-                    if (isOpening) evaluation += 3; // extra bonus for center control in opening
-                }
-            }
-            if (piece == 'p') {
-                if ((i == 3 || i == 4) && (j == 3 || j == 4)) {
-                    evaluation -= 5;
-                    if (isOpening) evaluation -= 3; // extra bonus for center control in opening
-                }
-            }
-        }
+int main(int argc, char* argv[]) {
+    if (argc > 1 && (string(argv[1]) == "perft" || string(argv[1]) == "divide")) {
+        return perftCommand(argc - 1, argv + 1);
     }
-    positionsEvaluated++;
-    return evaluation;
-}
-
-bool inBounds(int r, int f) { // check if a target square is on the board
-    return r >= 0 && r < 8 && f >= 0 && f < 8;
-}
-
-vector<string> enumeratePawnMoves(int r, int f, char piece) { // list all possible pawn moves for a given pawn
-    vector<string> moves;
-    int direction = 0;
-    switch (piece) { // get forwards direction of pawn
-        case 'P': direction = -1; break;
-        case 'p': direction = 1; break;
+    if (argc > 1 && string(argv[1]) == "batch") {
+        return batchCommand(argc - 1, argv + 1);
     }
-
-    if (inBounds(r + direction, f) && board[r + direction][f] == '.') { // check if square in front is empty
-        moves.push_back(to_string(r) + to_string(f) + to_string(r + direction) + to_string(f));
-        if ((piece == 'P' && r == 6) || (piece == 'p' && r == 1)) { // check if pawn is on starting square
-            if (inBounds(r + 2 * direction, f) && board[r + 2 * direction][f] == '.') { // then check two ahead
-                moves.push_back(to_string(r) + to_string(f) + to_string(r + 2*direction) + to_string(f));
-            }
-        }
+    if (argc > 1 && string(argv[1]) == "tb") {
+        return tbCommand(argc - 1, argv + 1);
     }
-
-    // captures
-    if (inBounds(r + direction, f - 1) && islower(board[r + direction][f - 1]) != islower(piece) && board[r + direction][f - 1] != '.') {
-        moves.push_back(to_string(r) + to_string(f) + to_string(r + direction) + to_string(f - 1));
+    if (argc > 1 && string(argv[1]) == "nnue") {
+        return nnueCommand(argc - 1, argv + 1);
     }
-
-    if (inBounds(r + direction, f + 1) && islower(board[r + direction][f + 1]) != islower(piece) && board[r + direction][f + 1] != '.') {
-        moves.push_back(to_string(r) + to_string(f) + to_string(r + direction) + to_string(f + 1));
+    if (argc > 1 && string(argv[1]) == "bench") {
+        return benchCommand(argc - 1, argv + 1);
     }
-    return moves;
-}
-
-vector<string> enumerateKnightMoves(int r, int f, char piece) { // list all possible knight moves for a given knight
-    vector<string> moves;
-    int knightMoves[8][2] = {{2, -1}, {2, 1}, {-2, -1}, {-2, 1}, {1, -2}, {1, 2}, {-1, -2}, {-1, 2}}; // knight move patterns
-
-    for (int i = 0; i < 8; i++) { // check each knight move pattern, capture or open square
-        int tr = r + knightMoves[i][0];
-        int tf = f + knightMoves[i][1];
-        if (inBounds(tr, tf)) {
-            if (board[tr][tf] == '.' || islower(board[tr][tf]) != islower(piece)) {
-                moves.push_back(to_string(r) + to_string(f) + to_string(tr) + to_string(tf));
-            }
-        }
+    if (argc > 1 && string(argv[1]) == "match") {
+        return matchCommand(argc - 1, argv + 1);
     }
-    return moves;
-}
-
-vector<string> enumerateBishopMoves(int r, int f, char piece) { // list all possible bishop moves for a given bishop
-    vector<string> moves;
-    int bishopDirections[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}}; // bishop move directions
-    for (int i = 0; i < 4; i++) {
-        int dr = bishopDirections[i][0];
-        int df = bishopDirections[i][1];
-        int tr = r + dr;
-        int tf = f + df;
-        while (inBounds(tr, tf)) { // keep moving in each direction until edge of board or blocked
-            if (board[tr][tf] == '.') {
-                moves.push_back(to_string(r) + to_string(f) + to_string(tr) + to_string(tf));
-            } else {
-                if (islower(board[tr][tf]) != islower(piece)) { // capture if blocked by other color
-                    moves.push_back(to_string(r) + to_string(f) + to_string(tr) + to_string(tf));
-                }
-                break;
-            }
-            tr += dr;
-            tf += df;
-        }
+    if (argc > 1 && string(argv[1]) == "server") {
+        return serverCommand(argc - 1, argv + 1);
     }
-    return moves;
-}
-
-vector<string> enumerateRookMoves(int r, int f, char piece) { // list all possible rook moves for a given rook
-    vector<string> moves;
-    int rookDirections[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}}; // rook move directions
-    for (int i = 0; i < 4; i++) {
-        int dr = rookDirections[i][0];
-        int df = rookDirections[i][1];
-        int tr = r + dr;
-        int tf = f + df;
-        while (inBounds(tr, tf)) { // keep moving in each direction until edge of board or blocked
-            if (board[tr][tf] == '.') {
-                moves.push_back(to_string(r) + to_string(f) + to_string(tr) + to_string(tf));
-            } else {
-                if (islower(board[tr][tf]) != islower(piece)) { // capture if blocked by other color
-                    moves.push_back(to_string(r) + to_string(f) + to_string(tr) + to_string(tf));
-                }
-                break;
-            }
-            tr += dr;
-            tf += df;
-        }
+    if (argc > 1 && string(argv[1]) == "cluster") {
+        return clusterCommand(argc - 1, argv + 1);
     }
-    return moves;
-}
-
-vector<string> enumerateQueenMoves(int r, int f, char piece) { // list all possible queen moves for a given queen
-    vector<string> moves;
-    int queenDirections[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}}; // queen move directions
-    for (int i = 0; i < 8; i++) {
-        int dr = queenDirections[i][0];
-        int df = queenDirections[i][1];
-        int tr = r + dr;
-        int tf = f + df;
-        while (inBounds(tr, tf)) { // keep moving in each direction until edge of board or blocked
-            if (board[tr][tf] == '.') {
-                moves.push_back(to_string(r) + to_string(f) + to_string(tr) + to_string(tf));
-            } else {
-                if (islower(board[tr][tf]) != islower(piece)) { // capture if blocked by other color
-                    moves.push_back(to_string(r) + to_string(f) + to_string(tr) + to_string(tf));
-                }
-                break;
-            }
-            tr += dr;
-            tf += df;
-        }
+    if (argc > 1 && string(argv[1]) == "uci") {
+        initBitboards();
+        Engine engine;
+        OpeningBook book;
+        engine.options.threads = 1;
+        return uciLoop(engine, book);
     }
-    return moves;
-}
 
-vector<string> enumerateKingMoves(int r, int f, char piece) { // list all possible king moves for a given king
-    vector<string> moves;
-    int kingDirections[8][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {1, -1}, {-1, 1}, {-1, -1}}; // king move directions
-    for (int i = 0; i < 8; i++) {
-        int tr = r + kingDirections[i][0];
-        int tf = f + kingDirections[i][1];
-        if (inBounds(tr, tf)) {
-            if (board[tr][tf] == '.' || islower(board[tr][tf]) != islower(piece)) {
-                moves.push_back(to_string(r) + to_string(f) + to_string(tr) + to_string(tf));
-            }
-        }
-    }
-/*  if (piece == 'K' && !whiteKingMoved) { // white castling
-        if (!whiteLeftRookMoved && board[7][1] == '.' && board[7][2] == '.' && board[7][3] == '.') {
-            moves.push_back("7472Q"); // queenside
-        }
-        if (!whiteRightRookMoved && board[7][5] == '.' && board[7][6] == '.') {
-            moves.push_back("7476K"); // kingside
-        }
-    }
-    if (piece == 'k' && !blackKingMoved) { // black castling
-        if (!blackLeftRookMoved && board[0][1] == '.' && board[0][2] == '.' && board[0][3] == '.') {
-            moves.push_back("0402Q"); // queenside
-        }
-        if (!blackRightRookMoved && board[0][5] == '.' && board[0][6] == '.') {
-            moves.push_back("0406K"); // kingside
-        }
-    }*/
-    return moves;
-}
-
-vector<string> enumeratePieceMoves(int r, int f) {
-    vector<string> moves;
-    char piece = board[r][f];
-    if (piece == '.') return moves; // no piece
-
-    switch (tolower(piece)) { // get moves for piece type
-        case 'p': moves = enumeratePawnMoves(r, f, piece); break;
-        case 'n': moves = enumerateKnightMoves(r, f, piece); break;
-        case 'b': moves = enumerateBishopMoves(r, f, piece); break;
-        case 'r': moves = enumerateRookMoves(r, f, piece); break;
-        case 'q': moves = enumerateQueenMoves(r, f, piece); break;
-        case 'k': moves = enumerateKingMoves(r, f, piece); break;
-    }
-    return moves; // return list of moves
-}
-
-vector<string> enumerateAllMoves(bool whiteToMove) {
-    vector<string> moves;
-    for (int r = 0; r < 8; r++) { // make every move for every piece of color
-        for (int f = 0; f < 8; f++) {
-            if (board[r][f] != '.' && (isupper(board[r][f]) == whiteToMove)) {
-                vector<string> pieceMoves = enumeratePieceMoves(r, f);
-                moves.insert(moves.end(), pieceMoves.begin(), pieceMoves.end());
-            }
-        }
-    }
-    return moves;
-}
-
-int enumerateMoveTree(int depth, int branches, bool whiteToMove, int currentEval) { // recursive evaluation of position
-    if (depth == 0) return immediateEvaluation(); // base case
-
-    if (depth < (engineDepth - 2)) { // basic pruning code
-        if (currentEval - immediateEvaluation() < -10) {
-            return immediateEvaluation();
-        } 
-    }
-
-    vector<string> moves = enumerateAllMoves(whiteToMove); // get moves
-    if (whiteToMove) { // for white
-        int te = -10000000; // initial value
-        #pragma omp parallel for // multithread with OpenMP
-        for (string move : moves) {
-            int r = move[0] - '0'; // make move
-            int f = move[1] - '0';
-            int tr = move[2] - '0';
-            int tf = move[3] - '0';
-            char captured = board[tr][tf];
-            board[tr][tf] = board[r][f];
-            board[r][f] = '.';
-            int evaluation = enumerateMoveTree(depth - 1, branches, false, currentEval); // evaluate
-            board[r][f] = board[tr][tf]; // undo move
-            board[tr][tf] = captured;
-            te = max(te, evaluation);
-        }
-        return te; // return evaluation
-    } else { // for black
-        int te = 10000000; 
-        #pragma omp parallel for // multithread with OpenMP
-        for (string move : moves) {
-            int r = move[0] - '0';
-            int f = move[1] - '0';
-            int tr = move[2] - '0';
-            int tf = move[3] - '0';
-            char captured = board[tr][tf];
-            board[tr][tf] = board[r][f];
-            board[r][f] = '.';
-            if (move.length() == 5) { //castling if K or Q is appended to move tag
-                if (move[4] == 'K') {
-                    board[0][5] = 'r';
-                    board[0][7] = '.';
-                }
-                if (move[4] == 'Q') {
-                    board[0][3] = 'r';
-                    board[0][0] = '.';
-                }
-            }
-            int evaluation = enumerateMoveTree(depth - 1, branches, true, currentEval);
-            board[r][f] = board[tr][tf];
-            board[tr][tf] = captured;
-            if (move.length() == 5) { // undo castling move
-                if (move[4] == 'K') {
-                    board[0][7] = 'r';
-                    board[0][5] = '.';
-                }
-                if (move[4] == 'Q') {
-                    board[0][0] = 'r';
-                    board[0][3] = '.';
-                }
+    int engineDepth = 5;
+    size_t hashMegabytes = 64;
+    bool largePages = false;
+    bool depthGiven = false;
+    bool ponder = true; // think on the human's time
+    string startFen = START_FEN;
+    string bookFile;
+    SearchOptions options;
+    SearchLimits limits;
+    options.threads = 0; // all hardware threads unless --threads is given
+    try { // a typo or an unknown subcommand ends with the usage, not an uncaught exception
+        for (int i = 1; i < argc; i++) {
+            string arg = argv[i];
+            if (arg == "--hash" && i + 1 < argc) {
+                hashMegabytes = stoul(argv[++i]);
+            } else if (arg == "--large-pages") {
+                largePages = true;
+            } else if (arg == "--threads" && i + 1 < argc) {
+                options.threads = max(1, stoi(argv[++i]));
+            } else if (arg == "--branches" && i + 1 < argc) {
+                options.branches = max(1, stoi(argv[++i]));
+            } else if (arg == "--beam-ply" && i + 1 < argc) {
+                options.beamPly = max(0, stoi(argv[++i]));
+            } else if (arg == "--movetime" && i + 1 < argc) { // ms per engine move
+                limits.movetime = stoll(argv[++i]);
+            } else if (arg == "--time" && i + 1 < argc) {     // engine clock in ms, with --inc per move
+                limits.time[BLACK] = stoll(argv[++i]);
+            } else if (arg == "--inc" && i + 1 < argc) {
+                limits.inc[BLACK] = stoll(argv[++i]);
+            } else if (arg == "--nodes" && i + 1 < argc) {
+                limits.nodes = stoull(argv[++i]);
+            } else if (arg == "--stats" && i + 1 < argc) { // append search statistics as JSON lines
+                options.statsFile = argv[++i];
+            } else if (arg == "--fen" && i + 1 < argc) {   // start from this position, black to move lets the engine go first
+                startFen = argv[++i];
+            } else if (arg == "--tb" && i + 1 < argc) {    // directory of tables from "chess tb generate"
+                if (!tbInit(argv[++i])) cout << "No tablebases in " << argv[i] << "\n";
+            } else if (arg == "--nnue" && i + 1 < argc) {  // evaluate with this network, see nnue.h
+                nnueEnabled = nnueLoad(argv[++i]);
+                if (!nnueEnabled) cout << "Cannot load network " << argv[i] << "\n";
+            } else if (arg == "--book" && i + 1 < argc) {  // Polyglot .bin opening book
+                bookFile = argv[++i];
+            } else if (arg == "--no-ponder") {
+                ponder = false;
+            } else {
+                engineDepth = stoi(arg);
+                depthGiven = true;
             }
-            te = min(te, evaluation);
         }
-        return te;
+    } catch (const exception&) {
+        cerr << "usage: chess [depth] [--hash MB] [--large-pages] [--threads N] [--branches N] [--beam-ply N]\n"
+                "             [--movetime ms] [--time ms] [--inc ms] [--nodes N] [--stats file] [--fen FEN]\n"
+                "             [--tb dir] [--nnue file] [--book file] [--no-ponder]\n"
+                "       chess uci | perft | divide | batch | bench | match | server | cluster | tb | nnue ...\n";
+        return 1;
     }
-}
-
-string selector(int depth, int branches, int currentEval) { // select best move for black
-    char backupBoard[8][8]; // Backup board data in case something goes wrong in selection
-    memcpy(backupBoard, board, sizeof(board));
-    bool backupWhiteKingMoved = whiteKingMoved;
-    bool backupBlackKingMoved = blackKingMoved;
-    bool backupWhiteLeftRookMoved = whiteLeftRookMoved;
-    bool backupWhiteRightRookMoved = whiteRightRookMoved;
-    bool backupBlackLeftRookMoved = blackLeftRookMoved;
-    bool backupBlackRightRookMoved = blackRightRookMoved;
-    bool backupCastled = castled;
-
-    vector<string> moves = enumerateAllMoves(false); // black to move
-    string bestMove;
-    int te = 10000000;
-    #pragma omp parallel for // multithread with OpenMP
-    for (string move : moves) {
-        int r = move[0] - '0'; // make move
-        int f = move[1] - '0';
-        int tr = move[2] - '0';
-        int tf = move[3] - '0';
-        char captured = board[tr][tf];
-        board[tr][tf] = board[r][f];
-        board[r][f] = '.';
-        if (move.length() == 5) { // castling if K or Q is appended to move tag
-            if (move[4] == 'K') {
-                board[0][5] = 'r';
-                board[0][7] = '.';
-            }
-            if (move[4] == 'Q') {
-                board[0][3] = 'r';
-                board[0][0] = '.';
-            }
-        }
-        int evaluation = enumerateMoveTree(depth - 1, branches, true, currentEval); // evaluate
-        board[r][f] = board[tr][tf]; // undo move
-        board[tr][tf] = captured;
-        if (move.length() == 5) { // undo castling move
-            if (move[4] == 'K') {
-                board[0][7] = 'r';
-                board[0][5] = '.';
-            }
-            if (move[4] == 'Q') {
-                board[0][0] = 'r';
-                board[0][3] = '.';
-            }
-        }
-        if (evaluation < te) { // if better than previous best move, set as new best move
-            te = evaluation;
-            bestMove = move;
-        }
-    }
-    return bestMove; // return best move
-
-    memcpy(board, backupBoard, sizeof(board)); // restore original board
-    whiteKingMoved = backupWhiteKingMoved;
-    blackKingMoved = backupBlackKingMoved;
-    whiteLeftRookMoved = backupWhiteLeftRookMoved;
-    whiteRightRookMoved = backupWhiteRightRookMoved;
-    blackLeftRookMoved = backupBlackLeftRookMoved;
-    blackRightRookMoved = backupBlackRightRookMoved;
-    castled = backupCastled;
-}
-
-string convertToCoordinates(string algebraic) { // convert lan to coordinates
-    string files = "abcdefgh";
-    string ranks = "87654321";
-
-    int fromRow = ranks.find(algebraic[1]);
-    int fromCol = files.find(algebraic[0]); 
-    int toRow = ranks.find(algebraic[3]);
-    int toCol = files.find(algebraic[2]);
-
-    return to_string(fromRow) + to_string(fromCol) + to_string(toRow) + to_string(toCol);
-}
-
-string convertToAlgebraic(string coordinates) { // convert coordinates to lan
-    string files = "abcdefgh";
-    string ranks = "87654321";
-
-    int fromRow = coordinates[0] - '0';
-    int fromCol = coordinates[1] - '0';
-    int toRow = coordinates[2] - '0';
-    int toCol = coordinates[3] - '0';
-
-    return string(1, files[fromCol]) + string(1, ranks[fromRow]) + string(1, files[toCol]) + string(1, ranks[toRow]);
-}
-
-void whiteCastleCheck(int r, int f) {
-    if (r == 7 && f == 4) whiteKingMoved = true;
-    if (r == 7 && f == 0) whiteLeftRookMoved = true;
-    if (r == 7 && f == 7) whiteRightRookMoved = true;
-}
-
-void blackCastleCheck(int r, int f) {
-    if (r == 0 && f == 4) blackKingMoved = true;
-    if (r == 0 && f == 0) blackLeftRookMoved = true;
-    if (r == 0 && f == 7) blackRightRookMoved = true;
-}
-
-int main(int argc, char* argv[]) {
-    if (argc == 2){
-        engineDepth = stoi(argv[1]);
+    if (depthGiven || (!limits.movetime && !limits.time[BLACK] && !limits.nodes)) {
+        limits.depth = engineDepth; // fixed depth unless only a clock or node budget was given
     }
 
     string move;
-    string response;
+    SearchResult response;
     int moveCount = 0;
-    bool moveValid;
     Timer timer;
+    thread ponderThread;   // searches while we wait for the human's move
+    Move ponderMove;       // the reply it expects, none when it searches the position itself
+    SearchResult ponderResult;
 
     cout << "Welcome to Chess Engine V0.5\n";
     cout << "(C) 2025 Tommy Ciccone All Rights Reserved.\n";
 
-    initializeBoard();
-    printBoard();
-    cout << "Evaluation: 0\n\n";
+    initBitboards();
+    Position board; // the game being played
+    if (!board.setFromFen(startFen)) {
+        cout << "Invalid FEN: " << startFen << "\n";
+        return 1;
+    }
+    OpeningBook book;
+    if (!bookFile.empty() && !book.open(bookFile)) {
+        cout << "Cannot open book " << bookFile << "\n";
+    }
+    Engine engine(hashMegabytes, largePages);
+    if (!options.threads) options.threads = engine.options.threads;
+    engine.options = options;
+    printBoard(board);
+    cout << "Evaluation: " << immediateEvaluation(board) << "\n\n";
+
+    auto stopPondering = [&]() {
+        if (!ponderThread.joinable()) return;
+        engine.stop();
+        ponderThread.join();
+        engine.pondering = false;
+    };
 
     while (true) {
-        cout << "Enter your move in Long Algebraic Notation or type quit to exit\n";
-        cout << "> ";
-        cin >> move;
-        if (move == "quit") break;
-
-        string coordinates = convertToCoordinates(move);
-        int r = coordinates[0] - '0';
-        int f = coordinates[1] - '0';
-        int tr = coordinates[2] - '0';
-        int tf = coordinates[3] - '0';
-
-        vector<string> legalMoves = enumerateAllMoves(true);
-        for (string lm : legalMoves) {
-            if (lm == coordinates) moveValid = true;
-        }
-
-        if (!moveValid) {
-            cout << "\nIllegal move, try again.\n\n";
-            moveValid = false;
-            continue;
-        }
+        UndoInfo undo;
+        bool ponderHit = false;
+        if (board.sideToMove == WHITE) {
+            cout << "Enter your move in Long Algebraic Notation or type quit to exit\n";
+            cout << "> ";
+            if (!(cin >> move) || move == "quit") break;
+            if (move == "uci" && moveCount == 0) { // a GUI started us
+                stopPondering();
+                return uciLoop(engine, book, move);
+            }
 
-        moveCount++;
+            Move playerMove = parseMove(board, move);
+            if (playerMove.isNone()) { // parseMove only matches legal moves
+                cout << "\nIllegal move, try again.\n\n";
+                continue;
+            }
 
-        moveValid = false;
+            moveCount++;
+
+            if (ponderThread.joinable()) {
+                ponderHit = !ponderMove.isNone() && playerMove == ponderMove;
+                if (ponderHit) { // keep searching, from now on against black's clock
+                    timer.start();
+                    engine.ponderhit();
+                    ponderThread.join();
+                    timer.stop();
+                } else {
+                    stopPondering(); // what it stored in the hash table still helps the real search
+                }
+            }
 
-        whiteCastleCheck(r, f);
+            board.makeMove(playerMove, undo);
 
-        board[tr][tf] = board[r][f];
-        board[r][f] = '.';
+            printBoard(board);
+            cout << "Evaluation: " << immediateEvaluation(board) << "\n\n";
+        }
 
-        printBoard();
-        cout << "Evaluation: " << immediateEvaluation() << "\n\n";
+        if (ponderHit) {
+            response = ponderResult;
+            cout << "Black expected " << move << " (ponder hit)\n\n";
+        } else {
+            Move bookMove = book.probe(board);
+            if (!bookMove.isNone()) {
+                cout << "Black plays: " << moveToString(bookMove) << " (book)\n";
+                board.makeMove(bookMove, undo);
+                printBoard(board);
+                cout << "Evaluation: " << immediateEvaluation(board) << "\n\n";
+                continue;
+            }
 
-        cout << "Black is thinking...\n\n";
-        positionsEvaluated = 0;
-        
-        timer.start();
-        response = selector(engineDepth, engineBranches, immediateEvaluation());
-        timer.stop();
-        if (response.size() < 4) {
+            cout << "Black is thinking...\n\n";
+            timer.start();
+            engine.newSearch();
+            response = engine.search(board, limits);
+            timer.stop();
+        }
+        if (limits.time[BLACK]) { // run the engine's clock
+            limits.time[BLACK] = max(1LL, limits.time[BLACK] - timer.getMilliseconds() + limits.inc[BLACK]);
+        }
+        if (response.bestMove.isNone()) {
             cout << "Black has no legal moves. Game over.\n";
             break;
         }
         
-        cout << "Black plays: " << convertToAlgebraic(response) << "\n";
-        cout << "Evaluated " << positionsEvaluated << " positions in " << timer.getTime() << " seconds.\n";
-
-        int br = response[0] - '0';
-        int bf = response[1] - '0';
-        int btr = response[2] - '0';
-        int btf = response[3] - '0';
-
-        blackCastleCheck(br, bf);
-
-        board[btr][btf] = board[br][bf];
-        board[br][bf] = '.';
-
-        if (response.length() == 5 && (response[4] == 'K' || response[4] == 'Q')) {
-            if (response[4] == 'K' && board[0][7] == 'r') {
-                board[0][5] = 'r';
-                board[0][7] = '.';
-            }
-            if (response[4] == 'Q' && board[0][0] == 'r') {
-                board[0][3] = 'r';
-                board[0][0] = '.';
+        long long ms = max(1LL, timer.getMilliseconds());
+        cout << "Black plays: " << moveToString(response.bestMove) << "\n";
+        cout << "Evaluated " << response.positionsEvaluated << " positions in " << timer.getTime() << " seconds.\n";
+        cout << "Searched " << response.nodes << " nodes to depth " << response.depth << " in " << ms << " ms ("
+             << response.nodes * 1000 / ms << " nodes/s, " << engine.options.threads << " threads).\n";
+
+        board.makeMove(response.bestMove, undo);
+
+        printBoard(board);
+        cout << "Evaluation: " << immediateEvaluation(board) << "\n\n";
+
+        if (ponder) { // search the reply the principal variation predicts, or the whole position without one
+            ponderMove = response.pvLength > 1 ? response.pv[1] : Move();
+            Position ponderRoot = board;
+            SearchLimits ponderLimits = limits;
+            if (ponderMove.isNone()) {
+                ponderLimits = SearchLimits();
+                ponderLimits.infinite = true; // only fills the hash table, stopped when the move comes
+            } else {
+                UndoInfo ponderUndo;
+                ponderRoot.makeMove(ponderMove, ponderUndo);
             }
-            castled = true;
+            engine.pondering = true;
+            engine.newSearch();
+            ponderThread = thread([&engine, &ponderResult, ponderRoot, ponderLimits]() {
+                ponderResult = engine.search(ponderRoot, ponderLimits);
+            });
         }
-
-        printBoard();
-        cout << "Evaluation: " << immediateEvaluation() << "\n\n";
     }
+    stopPondering();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,403 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "match.h"
+#include "movegen.h"
+#include "nnue.h"
+#include "search.h"
+#include "timer.h"
+
+using namespace std;
+
+// Common first moves, used when no --openings file is given.
+static const char* defaultOpenings[] = {
+    "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2", // 1.e4 e5
+    "rnbqkbnr/pp1ppppp/8/2p5/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2", // Sicilian
+    "rnbqkbnr/pppp1ppp/4p3/8/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2", // French
+    "rnbqkbnr/pp1ppppp/2p5/8/4P3/8/PPPP1PPP/RNBQKBNR w KQkq - 0 2", // Caro-Kann
+    "rnbqkbnr/ppp1pppp/8/3p4/3P4/8/PPP1PPPP/RNBQKBNR w KQkq - 0 2", // 1.d4 d5
+    "rnbqkb1r/pppppppp/5n2/8/3P4/8/PPP1PPPP/RNBQKBNR w KQkq - 1 2", // Indian
+    "rnbqkbnr/pppppppp/8/8/2P5/8/PP1PPPPP/RNBQKBNR b KQkq - 0 1",   // English
+    "rnbqkbnr/pppppppp/8/8/8/5N2/PPPPPPPP/RNBQKB1R b KQkq - 1 1",   // Reti
+};
+
+struct MatchPlayer {
+    string name;
+    SearchOptions options;
+    SearchLimits limits;   // depth, nodes or movetime; the clocks are filled in before every move
+    long long base = 0;    // ms on the clock at the start of a game, 0 for no clock
+    long long increment = 0;
+    size_t hashMegabytes = 16;
+};
+
+struct MatchConfig {
+    int games = 100;
+    int concurrency = 1;
+    bool adjudicate = true;
+    int drawStartPly = 80;  // no draw adjudication before move 40
+    int drawPlies = 10;     // consecutive plies both engines scored within drawScore of zero
+    int drawScore = 1;      // 10 cp
+    int maxPlies = 600;     // longer games are drawn
+    bool sprtStop = false;  // end the match as soon as the SPRT decides
+    double elo0 = 0, elo1 = 5;
+    double alpha = 0.05, beta = 0.05;
+};
+
+struct GameResult {
+    int score = 0;              // for A: 1 win, 0 draw, -1 loss
+    string result;              // "1-0", "0-1" or "1/2-1/2"
+    string reason;
+    int plies = 0;
+    uint64_t nodes[2] = {0, 0}; // by player, A then B
+    long long ns[2] = {0, 0};   // time spent searching
+};
+
+struct MatchState {
+    mutex lock;
+    atomic<int> nextGame{0};
+    atomic<bool> decided{false}; // the SPRT stopped the match
+    int wins = 0, draws = 0, losses = 0;
+    uint64_t nodes[2] = {0, 0};
+    long long ns[2] = {0, 0};
+};
+
+static bool insufficientMaterial(const Position& pos) { // bare kings, or one minor piece against a bare king
+    Bitboard heavy = pos.pieces[W_PAWN] | pos.pieces[B_PAWN] | pos.pieces[W_ROOK] | pos.pieces[B_ROOK]
+                   | pos.pieces[W_QUEEN] | pos.pieces[B_QUEEN];
+    return !heavy && popCount(pos.occupied) <= 3;
+}
+
+static bool threefold(const vector<uint64_t>& keys, int halfmoveClock) { // keys ends with the current position
+    int count = 1;
+    int earliest = max(0, int(keys.size()) - 1 - halfmoveClock); // nothing before the last capture or pawn move can repeat
+    for (int i = int(keys.size()) - 3; i >= earliest; i -= 2) {
+        if (keys[i] == keys.back() && ++count == 3) return true;
+    }
+    return false;
+}
+
+static void endGame(GameResult& g, int winner, bool aWhite, const char* reason) { // winner is a player, -1 for a draw
+    g.score = winner < 0 ? 0 : winner == 0 ? 1 : -1;
+    bool whiteWon = (winner == 0) == aWhite;
+    g.result = winner < 0 ? "1/2-1/2" : whiteWon ? "1-0" : "0-1";
+    g.reason = reason;
+}
+
+// Engines and players are indexed by player, A first; A has white when aWhite.
+static GameResult playGame(Engine* engines[2], const MatchPlayer* players[2], const Position& opening, bool aWhite,
+                           const MatchConfig& config) {
+    GameResult g;
+    Position pos = opening;
+    vector<uint64_t> keys{pos.key};
+    long long clocks[2] = {players[0]->base, players[1]->base};
+    int lastScore[2] = {0, 0};  // each player's last score, from its own point of view
+    bool moved[2] = {false, false};
+    int quietPlies = 0;
+    for (int p = 0; p < 2; p++) engines[p]->clear(); // nothing carries over from the previous game
+
+    while (true) {
+        int us = pos.sideToMove;
+        int p = (us == WHITE) == aWhite ? 0 : 1; // player to move
+        MoveList moves;
+        enumerateAllMoves(pos, moves);
+        if (moves.size() == 0) {
+            if (pos.inCheck()) endGame(g, 1 - p, aWhite, "checkmate");
+            else endGame(g, -1, aWhite, "stalemate");
+            break;
+        }
+        if (pos.halfmoveClock >= 100) { endGame(g, -1, aWhite, "fifty moves"); break; }
+        if (threefold(keys, pos.halfmoveClock)) { endGame(g, -1, aWhite, "repetition"); break; }
+        if (insufficientMaterial(pos)) { endGame(g, -1, aWhite, "insufficient material"); break; }
+        if (g.plies >= config.maxPlies) { endGame(g, -1, aWhite, "adjudication: length"); break; }
+
+        const MatchPlayer& player = *players[p];
+        SearchLimits limits = player.limits;
+        for (int q = 0; q < 2; q++) {
+            int color = (q == 0) == aWhite ? WHITE : BLACK;
+            limits.time[color] = clocks[q];
+            limits.inc[color] = players[q]->increment;
+        }
+        Timer timer;
+        timer.start();
+        engines[p]->newSearch();
+        SearchResult r = engines[p]->search(pos, limits);
+        timer.stop();
+        g.nodes[p] += r.nodes;
+        g.ns[p] += timer.getNanoseconds();
+        if (player.base > 0) {
+            clocks[p] -= timer.getMilliseconds();
+            if (clocks[p] < 0) { endGame(g, 1 - p, aWhite, "time forfeit"); break; }
+            clocks[p] += player.increment;
+        }
+
+        int score = us == WHITE ? r.score : -r.score;
+        if (config.adjudicate) {
+            if (moved[1 - p] && score >= MATE_SCORE - MAX_PLY && lastScore[1 - p] <= -(MATE_SCORE - MAX_PLY)) {
+                endGame(g, p, aWhite, "adjudication: mate"); // both sides see the same forced mate
+                break;
+            }
+            quietPlies = abs(score) <= config.drawScore ? quietPlies + 1 : 0;
+            if (g.plies >= config.drawStartPly && quietPlies >= config.drawPlies) {
+                endGame(g, -1, aWhite, "adjudication: draw");
+                break;
+            }
+        }
+        lastScore[p] = score;
+        moved[p] = true;
+
+        UndoInfo undo;
+        pos.makeMove(r.bestMove, undo);
+        keys.push_back(pos.key);
+        g.plies++;
+    }
+    return g;
+}
+
+static double scoreToElo(double score) {
+    score = min(max(score, 1e-6), 1.0 - 1e-6);
+    return 400.0 * log10(score / (1.0 - score));
+}
+
+static double eloToScore(double elo) {
+    return 1.0 / (1.0 + pow(10.0, -elo / 400.0));
+}
+
+static double gameVariance(int wins, int draws, int losses) { // of a single game's score
+    double n = wins + draws + losses;
+    double s = (wins + 0.5 * draws) / n;
+    return (wins * (1 - s) * (1 - s) + draws * (0.5 - s) * (0.5 - s) + losses * s * s) / n;
+}
+
+// Normal approximation of the log-likelihood ratio of elo1 against elo0, as used by most testing frameworks.
+static double sprtLlr(int wins, int draws, int losses, double elo0, double elo1) {
+    int n = wins + draws + losses;
+    if (n == 0) return 0;
+    double variance = gameVariance(wins, draws, losses);
+    if (variance <= 0) return 0;
+    double s = (wins + 0.5 * draws) / n;
+    double s0 = eloToScore(elo0), s1 = eloToScore(elo1);
+    return (s1 - s0) * (2 * s - s0 - s1) / (2 * variance / n);
+}
+
+static int sprtDecision(double llr, const MatchConfig& config) { // 1 accepts elo1, -1 accepts elo0, 0 needs more games
+    if (llr >= log((1 - config.beta) / config.alpha)) return 1;
+    if (llr <= log(config.beta / (1 - config.alpha))) return -1;
+    return 0;
+}
+
+static void printSummary(const MatchState& s, const MatchPlayer* players[2], const MatchConfig& config) {
+    int n = s.wins + s.draws + s.losses;
+    if (n == 0) return;
+    double score = (s.wins + 0.5 * s.draws) / n;
+    double margin = 1.96 * sqrt(gameVariance(s.wins, s.draws, s.losses) / n);
+    double elo = scoreToElo(score);
+    double error = (scoreToElo(score + margin) - scoreToElo(score - margin)) / 2;
+    double llr = sprtLlr(s.wins, s.draws, s.losses, config.elo0, config.elo1);
+    static const char* sprtNames[] = {"H0 accepted", "continue", "H1 accepted"};
+    char line[256];
+    snprintf(line, sizeof(line), "\nScore of %s vs %s: %d - %d - %d  [%.3f] %d\n", players[0]->name.c_str(),
+             players[1]->name.c_str(), s.wins, s.losses, s.draws, score, n);
+    cout << line;
+    snprintf(line, sizeof(line), "Elo difference: %.1f +/- %.1f (95%%)\n", elo, error);
+    cout << line;
+    snprintf(line, sizeof(line), "SPRT (elo0 %.1f, elo1 %.1f): LLR %.2f [%.2f, %.2f] %s\n", config.elo0, config.elo1, llr,
+             log(config.beta / (1 - config.alpha)), log((1 - config.beta) / config.alpha), sprtNames[sprtDecision(llr, config) + 1]);
+    cout << line;
+    for (int p = 0; p < 2; p++) {
+        long long ms = max(1LL, s.ns[p] / 1000000);
+        cout << players[p]->name << ": " << s.nodes[p] << " nodes in " << ms << " ms, " << s.nodes[p] * 1000 / ms << " nps\n";
+    }
+}
+
+static void playGames(MatchState& s, const MatchPlayer* players[2], const vector<Position>& openings, const MatchConfig& config) {
+    unique_ptr<Engine> owned[2];
+    Engine* engines[2];
+    for (int p = 0; p < 2; p++) {
+        owned[p].reset(new Engine(players[p]->hashMegabytes));
+        owned[p]->options = players[p]->options;
+        engines[p] = owned[p].get();
+    }
+    while (!s.decided) {
+        int game = s.nextGame++;
+        if (game >= config.games) return;
+        int opening = (game / 2) % int(openings.size());
+        bool aWhite = game % 2 == 0; // every opening once with each color
+        GameResult g = playGame(engines, players, openings[opening], aWhite, config);
+
+        lock_guard<mutex> lock(s.lock);
+        if (g.score > 0) s.wins++;
+        else if (g.score < 0) s.losses++;
+        else s.draws++;
+        for (int p = 0; p < 2; p++) {
+            s.nodes[p] += g.nodes[p];
+            s.ns[p] += g.ns[p];
+        }
+        const MatchPlayer* white = players[aWhite ? 0 : 1];
+        const MatchPlayer* black = players[aWhite ? 1 : 0];
+        cout << "Game " << game + 1 << " (" << white->name << " - " << black->name << ", opening " << opening + 1 << "): "
+             << g.result << " " << g.reason << ", " << g.plies << " plies; " << players[0]->name << " +" << s.wins
+             << " =" << s.draws << " -" << s.losses << endl;
+        if (config.sprtStop && sprtDecision(sprtLlr(s.wins, s.draws, s.losses, config.elo0, config.elo1), config) != 0) {
+            s.decided = true;
+        }
+    }
+}
+
+static bool parseClock(const string& text, long long& base, long long& increment) { // ms, "base" or "base+inc"
+    size_t plus = text.find('+');
+    try {
+        base = stoll(text.substr(0, plus));
+        increment = plus == string::npos ? 0 : stoll(text.substr(plus + 1));
+    } catch (...) {
+        return false;
+    }
+    return base > 0 && increment >= 0;
+}
+
+static bool setOption(MatchPlayer& player, const string& key, const string& value) {
+    try {
+        if (key == "name") player.name = value;
+        else if (key == "depth") player.limits.depth = max(1, stoi(value));
+        else if (key == "nodes") player.limits.nodes = stoull(value);
+        else if (key == "movetime") player.limits.movetime = stoll(value);
+        else if (key == "tc") return parseClock(value, player.base, player.increment);
+        else if (key == "threads") player.options.threads = max(1, stoi(value));
+        else if (key == "hash") player.hashMegabytes = max(1, stoi(value));
+        else if (key == "nnue") player.options.useNnue = value == "on";
+        else if (key == "branches") player.options.branches = max(1, stoi(value));
+        else if (key == "beamply") player.options.beamPly = max(0, stoi(value));
+        else return setSearchParameter(player.options, key, stoi(value));
+    } catch (...) {
+        return false;
+    }
+    return true;
+}
+
+static bool setOptions(MatchPlayer& player, const string& spec) { // "key=value,key=value"
+    stringstream in(spec);
+    string item;
+    while (getline(in, item, ',')) {
+        if (item.empty()) continue;
+        size_t equals = item.find('=');
+        if (equals == string::npos || !setOption(player, item.substr(0, equals), item.substr(equals + 1))) {
+            cerr << "bad engine option " << item << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool loadOpenings(const string& path, vector<Position>& openings) { // FEN or EPD, one per line
+    ifstream in(path);
+    if (!in) return false;
+    string line;
+    while (getline(in, line)) {
+        size_t start = line.find_first_not_of(" \t\r");
+        if (start == string::npos || line[start] == '#') continue;
+        Position pos;
+        if (pos.setFromFen(line.substr(start))) openings.push_back(pos);
+        else cerr << "skipping opening " << line << "\n";
+    }
+    return true;
+}
+
+int matchCommand(int argc, char* argv[]) {
+    MatchConfig config;
+    MatchPlayer players[2];
+    players[0].name = "A";
+    players[1].name = "B";
+    players[0].options.threads = players[1].options.threads = 1;
+    string shared, specs[2], openingsPath;
+    int concurrency = 0;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--games" && i + 1 < argc) {
+            config.games = max(1, stoi(argv[++i]));
+        } else if (arg == "--concurrency" && i + 1 < argc) {
+            concurrency = max(1, stoi(argv[++i]));
+        } else if (arg == "--openings" && i + 1 < argc) {
+            openingsPath = argv[++i];
+        } else if (arg == "--tc" && i + 1 < argc) { // settings for both sides, --a and --b override them
+            shared += string(",tc=") + argv[++i];
+        } else if (arg == "--depth" && i + 1 < argc) {
+            shared += string(",depth=") + argv[++i];
+        } else if (arg == "--a" && i + 1 < argc) {
+            specs[0] = argv[++i];
+        } else if (arg == "--b" && i + 1 < argc) {
+            specs[1] = argv[++i];
+        } else if (arg == "--sprt" && i + 1 < argc) {
+            if (sscanf(argv[++i], "%lf,%lf", &config.elo0, &config.elo1) != 2) {
+                cerr << "--sprt wants elo0,elo1\n";
+                return 1;
+            }
+            config.sprtStop = true;
+        } else if (arg == "--nnue" && i + 1 < argc) { // the network for every engine with nnue=on, the default
+            nnueEnabled = nnueLoad(argv[++i]);
+            if (!nnueEnabled) {
+                cerr << "cannot load network " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (arg == "--no-adjudication") {
+            config.adjudicate = false;
+        } else {
+            cerr << "usage: chess match [--games N] [--concurrency N] [--openings file] [--tc base[+inc]] [--depth N]\n"
+                    "                   [--a options] [--b options] [--sprt elo0,elo1] [--nnue file] [--no-adjudication]\n";
+            return 1;
+        }
+    }
+    for (int p = 0; p < 2; p++) {
+        if (!setOptions(players[p], shared) || !setOptions(players[p], specs[p])) return 1;
+        const SearchLimits& l = players[p].limits;
+        if (!l.depth && !l.nodes && !l.movetime && !players[p].base) players[p].limits.depth = 6;
+    }
+
+    initBitboards();
+    vector<Position> openings;
+    if (!openingsPath.empty()) {
+        if (!loadOpenings(openingsPath, openings)) {
+            cerr << "cannot open " << openingsPath << "\n";
+            return 1;
+        }
+    } else {
+        for (const char* fen : defaultOpenings) {
+            openings.emplace_back();
+            openings.back().setFromFen(fen);
+        }
+    }
+    if (openings.empty()) {
+        cerr << "no openings\n";
+        return 1;
+    }
+
+    // Every game runs two engines one after the other, so a game needs the larger thread count.
+    int threadsPerGame = max(players[0].options.threads, players[1].options.threads);
+    config.concurrency = concurrency ? concurrency : max(1, int(thread::hardware_concurrency()) / threadsPerGame);
+    config.concurrency = min(config.concurrency, config.games);
+    cout << players[0].name << " vs " << players[1].name << ": " << config.games << " games, " << config.concurrency
+         << " at a time, " << openings.size() << " openings\n";
+
+    const MatchPlayer* playerRefs[2] = {&players[0], &players[1]};
+    MatchState s;
+    vector<thread> threads;
+    for (int i = 0; i < config.concurrency; i++) {
+        threads.emplace_back(playGames, ref(s), playerRefs, cref(openings), cref(config));
+    }
+    for (thread& t : threads) t.join();
+    printSummary(s, playerRefs, config);
+    return 0;
+}
@@ -0,0 +1,21 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+// Self-play between two engine configurations, A and B, to tell whether a change is stronger and not
+// just faster. Every opening is played twice with colors reversed, several games at a time, each game
+// with its own pair of engines and positions. Games end by the rules (mate, stalemate, threefold
+// repetition, fifty moves, insufficient material), by time forfeit, or by adjudication: a mate both
+// engines agree on, a long stretch of near-zero scores, or a length cap. Reports W/D/L for A, Elo with
+// a 95% interval, the SPRT log-likelihood ratio against its bounds, and each engine's nps.
+//
+// chess match [--games N] [--concurrency N] [--openings file] [--tc base[+inc]] [--depth N]
+//             [--a options] [--b options] [--sprt elo0,elo1] [--nnue file] [--no-adjudication]
+// options are comma separated key=value pairs overriding the shared settings for one side:
+//     name, depth, nodes, movetime (ms), tc (ms base[+inc]), threads, hash (MB), nnue (on/off),
+//     branches, beamply, and the selective search parameters by their UCI names (NullMoveDepth=0, ...)
+int matchCommand(int argc, char* argv[]);
@@ -0,0 +1,61 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+enum MoveFlag { // upper four bits of a move, bit 2 marks captures and bit 3 promotions
+    QUIET = 0,
+    DOUBLE_PUSH = 1,
+    KING_CASTLE = 2,
+    QUEEN_CASTLE = 3,
+    CAPTURE = 4,
+    EN_PASSANT = 5,
+    PROMOTION = 8,         // + 0..3 for knight, bishop, rook, queen
+    PROMOTION_CAPTURE = 12 // + 0..3 for knight, bishop, rook, queen
+};
+
+class Move { // packed 16 bit move: from (6 bits), to (6 bits), flags (4 bits)
+    public:
+        Move() : data(0) {}
+        Move(int from, int to, int flags = QUIET) : data(uint16_t(from | (to << 6) | (flags << 12))) {}
+
+        int from() const { return data & 63; }
+        int to() const { return (data >> 6) & 63; }
+        int flags() const { return data >> 12; }
+
+        bool isCapture() const { return data & (CAPTURE << 12); }
+        bool isPromotion() const { return data & (PROMOTION << 12); }
+        bool isCastle() const { return flags() == KING_CASTLE || flags() == QUEEN_CASTLE; }
+        int promotionType() const { return 1 + (flags() & 3); } // KNIGHT .. QUEEN
+
+        uint16_t raw() const { return data; }
+        static Move fromRaw(uint16_t raw) { Move m; m.data = raw; return m; }
+
+        bool isNone() const { return data == 0; } // a1a1 never occurs, so zero means "no move"
+        bool operator==(Move other) const { return data == other.data; }
+        bool operator!=(Move other) const { return data != other.data; }
+
+    private:
+        uint16_t data;
+};
+
+const int MAX_MOVES = 256; // no legal position has more than 218 moves
+
+struct MoveList { // fixed capacity move list, lives on the stack
+    Move moves[MAX_MOVES];
+    int count = 0;
+
+    void add(Move m) { moves[count++] = m; }
+    int size() const { return count; }
+    Move& operator[](int i) { return moves[i]; }
+    Move operator[](int i) const { return moves[i]; }
+    Move* begin() { return moves; }
+    Move* end() { return moves + count; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + count; }
+};
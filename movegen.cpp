@@ -0,0 +1,198 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include "movegen.h"
+
+using namespace std;
+
+// Everything a node needs to know to generate only legal moves, computed once per position.
+struct LegalityInfo {
+    int king;             // our king's square
+    Bitboard checkers;    // enemy pieces giving check
+    Bitboard pinned;      // our pieces that may only move along the line to our king
+    Bitboard evasionMask; // squares a non-king move must land on: anywhere, or block / capture the single checker
+};
+
+static LegalityInfo computeLegality(const Position& pos, int us) {
+    LegalityInfo info;
+    int them = us ^ 1;
+    info.king = pos.kingSquare(us);
+    info.checkers = pos.attackersTo(info.king, pos.occupied) & pos.colors[them];
+    info.pinned = 0;
+
+    Bitboard diagonal = pos.byType(them, BISHOP) | pos.byType(them, QUEEN);
+    Bitboard straight = pos.byType(them, ROOK) | pos.byType(them, QUEEN);
+    Bitboard snipers = (bishopAttacks(info.king, 0) & diagonal) | (rookAttacks(info.king, 0) & straight);
+    while (snipers) { // a slider with exactly one piece between it and our king pins that piece if it is ours
+        int sq = popLsb(snipers);
+        Bitboard blockers = betweenTable[info.king][sq] & pos.occupied;
+        if (blockers && !moreThanOne(blockers)) info.pinned |= blockers & pos.colors[us];
+    }
+
+    if (!info.checkers) info.evasionMask = ~Bitboard(0);
+    else if (moreThanOne(info.checkers)) info.evasionMask = 0; // double check, only the king can move
+    else info.evasionMask = betweenTable[info.king][lsb(info.checkers)] | info.checkers;
+    return info;
+}
+
+static void addMoves(MoveList& moves, int from, Bitboard targets, int flags) { // one move per target square
+    while (targets) {
+        moves.add(Move(from, popLsb(targets), flags));
+    }
+}
+
+static void addPawnMoves(MoveList& moves, Bitboard targets, int offset, int flags) { // from = to - offset
+    while (targets) {
+        int to = popLsb(targets);
+        moves.add(Move(to - offset, to, flags));
+    }
+}
+
+static void addPromotions(MoveList& moves, Bitboard targets, int offset, bool capture, bool queenOnly) {
+    int base = capture ? PROMOTION_CAPTURE : PROMOTION;
+    while (targets) {
+        int to = popLsb(targets);
+        moves.add(Move(to - offset, to, base + 3)); // queen first
+        if (queenOnly) continue;
+        moves.add(Move(to - offset, to, base + 0));
+        moves.add(Move(to - offset, to, base + 2));
+        moves.add(Move(to - offset, to, base + 1));
+    }
+}
+
+// Pawns that may all land anywhere in allowed: the unpinned pawns together, or one pinned pawn
+// restricted to its pin line. In captures mode quiet pushes and underpromotions are left out.
+static void enumeratePawnMoves(const Position& pos, MoveList& moves, int us, Bitboard pawns, Bitboard allowed, bool capturesOnly) {
+    Bitboard empty = ~pos.occupied;
+    Bitboard enemies = pos.colors[us ^ 1];
+    Bitboard lastRank = us == WHITE ? RANK_8 : RANK_1;
+    int up = us == WHITE ? 8 : -8;
+
+    Bitboard single = (us == WHITE ? shiftNorth(pawns) : shiftSouth(pawns)) & empty; // square in front is empty
+    Bitboard twice = (us == WHITE ? shiftNorth(single & RANK_3) : shiftSouth(single & RANK_6)) & empty & allowed; // then two ahead
+    Bitboard west = (us == WHITE ? shiftNorthWest(pawns) : shiftSouthWest(pawns)) & enemies & allowed; // captures
+    Bitboard east = (us == WHITE ? shiftNorthEast(pawns) : shiftSouthEast(pawns)) & enemies & allowed;
+    single &= allowed;
+
+    if (!capturesOnly) {
+        addPawnMoves(moves, single & ~lastRank, up, QUIET);
+        addPawnMoves(moves, twice, 2 * up, DOUBLE_PUSH);
+    }
+    addPawnMoves(moves, west & ~lastRank, up - 1, CAPTURE);
+    addPawnMoves(moves, east & ~lastRank, up + 1, CAPTURE);
+    addPromotions(moves, single & lastRank, up, false, capturesOnly);
+    addPromotions(moves, west & lastRank, up - 1, true, capturesOnly);
+    addPromotions(moves, east & lastRank, up + 1, true, capturesOnly);
+}
+
+// En passant takes two pawns off one rank at once, which can uncover a slider that no pin test sees,
+// so each capture is simply tried against the occupancy it would leave behind.
+static void enumerateEnPassant(const Position& pos, MoveList& moves, int us, const LegalityInfo& info) {
+    if (pos.epSquare == NO_SQUARE) return;
+    int them = us ^ 1;
+    int captured = pos.epSquare + (us == WHITE ? -8 : 8);
+    Bitboard attackers = pawnAttackTable[them][pos.epSquare] & pos.byType(us, PAWN);
+    while (attackers) {
+        int from = popLsb(attackers);
+        Bitboard occ = (pos.occupied ^ squareBit(from) ^ squareBit(captured)) | squareBit(pos.epSquare);
+        Bitboard checks = (bishopAttacks(info.king, occ) & (pos.byType(them, BISHOP) | pos.byType(them, QUEEN)))
+                        | (rookAttacks(info.king, occ) & (pos.byType(them, ROOK) | pos.byType(them, QUEEN)))
+                        | (knightAttackTable[info.king] & pos.byType(them, KNIGHT))
+                        | (pawnAttackTable[us][info.king] & pos.byType(them, PAWN));
+        if (!(checks & ~squareBit(captured))) moves.add(Move(from, pos.epSquare, EN_PASSANT));
+    }
+}
+
+static void enumerateKingMoves(const Position& pos, MoveList& moves, int us, const LegalityInfo& info, bool capturesOnly) {
+    int them = us ^ 1;
+    Bitboard withoutKing = pos.occupied ^ squareBit(info.king); // the king cannot hide from a slider behind itself
+    Bitboard targets = kingAttackTable[info.king] & ~pos.colors[us];
+    if (capturesOnly) targets &= pos.colors[them];
+    while (targets) {
+        int to = popLsb(targets);
+        if (pos.attackersTo(to, withoutKing) & pos.colors[them]) continue;
+        moves.add(Move(info.king, to, (pos.colors[them] & squareBit(to)) ? CAPTURE : QUIET));
+    }
+}
+
+static void enumerateCastlingMoves(const Position& pos, MoveList& moves, int us) { // only called when not in check
+    int them = us ^ 1;
+    int rank = us == WHITE ? 0 : 7;
+    int king = makeSquare(rank, 4);
+    int oo = us == WHITE ? WHITE_OO : BLACK_OO;
+    int ooo = us == WHITE ? WHITE_OOO : BLACK_OOO;
+    if (!(pos.castlingRights & (oo | ooo)) || pos.pieceOn(king) != makePiece(us, KING)) return;
+
+    if ((pos.castlingRights & oo) && !(pos.occupied & (squareBit(king + 1) | squareBit(king + 2)))) { // kingside
+        if (!pos.isAttacked(king + 1, them) && !pos.isAttacked(king + 2, them)) {
+            moves.add(Move(king, king + 2, KING_CASTLE));
+        }
+    }
+    if ((pos.castlingRights & ooo) && !(pos.occupied & (squareBit(king - 1) | squareBit(king - 2) | squareBit(king - 3)))) { // queenside
+        if (!pos.isAttacked(king - 1, them) && !pos.isAttacked(king - 2, them)) {
+            moves.add(Move(king, king - 2, QUEEN_CASTLE));
+        }
+    }
+}
+
+static void enumerateLegalMoves(const Position& pos, MoveList& moves, bool capturesOnly) {
+    int us = pos.sideToMove;
+    Bitboard occ = pos.occupied;
+    Bitboard enemies = pos.colors[us ^ 1];
+    LegalityInfo info = computeLegality(pos, us);
+
+    enumerateKingMoves(pos, moves, us, info, capturesOnly);
+    if (moreThanOne(info.checkers)) return;
+
+    // A pinned piece can never answer a check: its pin line and the check ray only meet at the king.
+    Bitboard movable = info.checkers ? ~info.pinned : ~Bitboard(0);
+    Bitboard allowed = info.evasionMask & ~pos.colors[us];
+    if (capturesOnly) allowed &= enemies;
+    Bitboard pawnAllowed = capturesOnly ? info.evasionMask & (enemies | RANK_1 | RANK_8) : info.evasionMask;
+
+    Bitboard pawns = pos.byType(us, PAWN) & movable;
+    enumeratePawnMoves(pos, moves, us, pawns & ~info.pinned, pawnAllowed, capturesOnly);
+    for (Bitboard b = pawns & info.pinned; b; ) {
+        int sq = popLsb(b);
+        enumeratePawnMoves(pos, moves, us, squareBit(sq), pawnAllowed & lineTable[info.king][sq], capturesOnly);
+    }
+    enumerateEnPassant(pos, moves, us, info);
+
+    for (Bitboard b = pos.byType(us, KNIGHT) & ~info.pinned; b; ) { // a pinned knight can never stay on its line
+        int sq = popLsb(b);
+        Bitboard targets = knightAttackTable[sq] & allowed;
+        addMoves(moves, sq, targets & enemies, CAPTURE);
+        addMoves(moves, sq, targets & ~occ, QUIET);
+    }
+    for (Bitboard b = (pos.byType(us, BISHOP) | pos.byType(us, ROOK) | pos.byType(us, QUEEN)) & movable; b; ) {
+        int sq = popLsb(b);
+        int type = typeOf(pos.pieceOn(sq));
+        Bitboard targets = type == BISHOP ? bishopAttacks(sq, occ) : type == ROOK ? rookAttacks(sq, occ) : queenAttacks(sq, occ);
+        targets &= allowed;
+        if (info.pinned & squareBit(sq)) targets &= lineTable[info.king][sq];
+        addMoves(moves, sq, targets & enemies, CAPTURE);
+        addMoves(moves, sq, targets & ~occ, QUIET);
+    }
+
+    if (!capturesOnly && !info.checkers) enumerateCastlingMoves(pos, moves, us);
+}
+
+void enumerateAllMoves(const Position& pos, MoveList& moves) {
+    enumerateLegalMoves(pos, moves, false);
+}
+
+void enumerateCaptures(const Position& pos, MoveList& moves) {
+    enumerateLegalMoves(pos, moves, true);
+}
+
+Move parseMove(const Position& pos, const string& lan) {
+    MoveList moves;
+    enumerateAllMoves(pos, moves);
+    for (Move m : moves) {
+        if (moveToString(m) == lan) return m;
+    }
+    return Move();
+}
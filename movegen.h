@@ -0,0 +1,16 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+#include <string>
+#include "move.h"
+#include "position.h"
+
+void enumerateAllMoves(const Position& pos, MoveList& moves); // legal moves for the side to move
+void enumerateCaptures(const Position& pos, MoveList& moves);  // legal captures and queen promotions only
+
+Move parseMove(const Position& pos, const std::string& lan); // match a long algebraic move, none if not legal
@@ -0,0 +1,484 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "evaluate.h"
+#include "nnue.h"
+#include "position.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define NNUE_X86 // SIMD kernels are compiled per function with target attributes and picked at runtime
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+bool nnueEnabled = false;
+
+// A network file is this header followed by the parameters, each block starting on a 64 byte
+// boundary, all little-endian: feature transformer biases (int16 x NNUE_HIDDEN) and weights
+// (int16 x NNUE_HIDDEN per feature), then for each later layer int32 biases and int8 weights,
+// one row of inputs per output.
+struct NnueHeader {
+    char magic[4];       // "CENN"
+    uint32_t version;    // 1
+    uint32_t features;   // must match the constants in nnue.h
+    uint32_t hidden;
+    uint32_t l1;
+    uint32_t l2;
+    int32_t outputScale; // network output per evaluation unit
+    char description[36];
+};
+static_assert(sizeof(NnueHeader) == 64, "network header is 64 bytes");
+
+enum { FT_BIAS, FT_WEIGHTS, L1_BIAS, L1_WEIGHTS, L2_BIAS, L2_WEIGHTS, OUT_BIAS, OUT_WEIGHTS, BLOCKS };
+
+struct NetworkLayout {
+    size_t offsets[BLOCKS];
+    size_t bytes;
+};
+
+static NetworkLayout networkLayout() {
+    const size_t sizes[BLOCKS] = {
+        2 * NNUE_HIDDEN, 2 * size_t(NNUE_FEATURES) * NNUE_HIDDEN,
+        4 * NNUE_L1, size_t(NNUE_L1) * 2 * NNUE_HIDDEN,
+        4 * NNUE_L2, size_t(NNUE_L2) * NNUE_L1,
+        4, NNUE_L2
+    };
+    NetworkLayout layout;
+    size_t at = sizeof(NnueHeader);
+    for (int i = 0; i < BLOCKS; i++) {
+        layout.offsets[i] = at;
+        at = (at + sizes[i] + 63) & ~size_t(63);
+    }
+    layout.bytes = at;
+    return layout;
+}
+
+struct Network {
+    const int16_t* ftBias = nullptr;
+    const int16_t* ftWeights = nullptr;
+    const int32_t* l1Bias = nullptr;
+    const int8_t* l1Weights = nullptr;
+    const int32_t* l2Bias = nullptr;
+    const int8_t* l2Weights = nullptr;
+    const int32_t* outBias = nullptr;
+    const int8_t* outWeights = nullptr;
+    int outputScale = 1;
+    void* base = nullptr;
+    size_t bytes = 0;
+    bool mapped = false;
+};
+
+static Network net;
+
+struct NnueKernels {
+    const char* name;
+    void (*addSub)(int16_t* acc, const int16_t* add, const int16_t* sub); // either row may be null
+    void (*transform)(const int16_t* acc, uint8_t* out);                 // NNUE_HIDDEN values clipped to 0..127
+    void (*affine)(const uint8_t* in, const int8_t* weights, const int32_t* bias, int32_t* out, int inputs, int outputs);
+};
+
+static void addSubScalar(int16_t* acc, const int16_t* add, const int16_t* sub) {
+    if (add) for (int i = 0; i < NNUE_HIDDEN; i++) acc[i] += add[i];
+    if (sub) for (int i = 0; i < NNUE_HIDDEN; i++) acc[i] -= sub[i];
+}
+
+static void transformScalar(const int16_t* acc, uint8_t* out) {
+    for (int i = 0; i < NNUE_HIDDEN; i++) out[i] = uint8_t(min(127, max(0, int(acc[i]))));
+}
+
+static void affineScalar(const uint8_t* in, const int8_t* weights, const int32_t* bias, int32_t* out, int inputs, int outputs) {
+    for (int o = 0; o < outputs; o++) {
+        const int8_t* row = weights + o * inputs;
+        int32_t sum = bias[o];
+        for (int i = 0; i < inputs; i++) sum += in[i] * row[i];
+        out[o] = sum;
+    }
+}
+
+static const NnueKernels scalarKernels = {"scalar", addSubScalar, transformScalar, affineScalar};
+
+#ifdef NNUE_X86
+__attribute__((target("sse4.1")))
+static void addSubSse41(int16_t* acc, const int16_t* add, const int16_t* sub) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        if (add) v = _mm_add_epi16(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(add + i)));
+        if (sub) v = _mm_sub_epi16(v, _mm_loadu_si128(reinterpret_cast<const __m128i*>(sub + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + i), v);
+    }
+}
+
+__attribute__((target("sse4.1")))
+static void transformSse41(const int16_t* acc, uint8_t* out) {
+    const __m128i zero = _mm_setzero_si128();
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i + 8));
+        __m128i packed = _mm_max_epi8(_mm_packs_epi16(a, b), zero); // saturate to -128..127, then cut at 0
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), packed);
+    }
+}
+
+__attribute__((target("sse4.1")))
+static __m128i dotSse41(const uint8_t* in, const int8_t* row, int inputs) { // four partial int32 sums
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < inputs; i += 16) { // u8 x i8 pairs into i16, then pairs of those into i32
+        __m128i products = _mm_maddubs_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)),
+                                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i)));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(products, ones));
+    }
+    return sum;
+}
+
+__attribute__((target("sse4.1")))
+static void affineSse41(const uint8_t* in, const int8_t* weights, const int32_t* bias, int32_t* out, int inputs, int outputs) {
+    const __m128i ones = _mm_set1_epi16(1);
+    int o = 0;
+    for (; o + 4 <= outputs; o += 4) { // four rows at a time, each input block loaded once and the sums reduced together
+        const int8_t* row = weights + o * inputs;
+        __m128i s0 = _mm_setzero_si128(), s1 = s0, s2 = s0, s3 = s0;
+        for (int i = 0; i < inputs; i += 16) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+            s0 = _mm_add_epi32(s0, _mm_madd_epi16(_mm_maddubs_epi16(x, _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i))), ones));
+            s1 = _mm_add_epi32(s1, _mm_madd_epi16(_mm_maddubs_epi16(x, _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + inputs + i))), ones));
+            s2 = _mm_add_epi32(s2, _mm_madd_epi16(_mm_maddubs_epi16(x, _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 2 * inputs + i))), ones));
+            s3 = _mm_add_epi32(s3, _mm_madd_epi16(_mm_maddubs_epi16(x, _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 3 * inputs + i))), ones));
+        }
+        __m128i sums = _mm_hadd_epi32(_mm_hadd_epi32(s0, s1), _mm_hadd_epi32(s2, s3));
+        sums = _mm_add_epi32(sums, _mm_loadu_si128(reinterpret_cast<const __m128i*>(bias + o)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), sums);
+    }
+    for (; o < outputs; o++) {
+        __m128i sum = dotSse41(in, weights + o * inputs, inputs);
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+        out[o] = bias[o] + _mm_cvtsi128_si32(sum);
+    }
+}
+
+__attribute__((target("avx2")))
+static void addSubAvx2(int16_t* acc, const int16_t* add, const int16_t* sub) {
+    for (int i = 0; i < NNUE_HIDDEN; i += 16) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        if (add) v = _mm256_add_epi16(v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(add + i)));
+        if (sub) v = _mm256_sub_epi16(v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sub + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + i), v);
+    }
+}
+
+__attribute__((target("avx2")))
+static void transformAvx2(const int16_t* acc, uint8_t* out) {
+    const __m256i zero = _mm256_setzero_si256();
+    for (int i = 0; i < NNUE_HIDDEN; i += 32) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i + 16));
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(a, b), 0xD8); // packs works per 128 bit lane
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_max_epi8(packed, zero));
+    }
+}
+
+__attribute__((target("avx2")))
+static __m256i dotAvx2(const uint8_t* in, const int8_t* row, int inputs) { // eight partial int32 sums
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < inputs; i += 32) {
+        __m256i products = _mm256_maddubs_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)),
+                                                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i)));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, ones));
+    }
+    return sum;
+}
+
+__attribute__((target("avx2")))
+static void affineAvx2(const uint8_t* in, const int8_t* weights, const int32_t* bias, int32_t* out, int inputs, int outputs) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    int o = 0;
+    for (; o + 4 <= outputs; o += 4) { // as in affineSse41
+        const int8_t* row = weights + o * inputs;
+        __m256i s0 = _mm256_setzero_si256(), s1 = s0, s2 = s0, s3 = s0;
+        for (int i = 0; i < inputs; i += 32) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            s0 = _mm256_add_epi32(s0, _mm256_madd_epi16(_mm256_maddubs_epi16(x, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i))), ones));
+            s1 = _mm256_add_epi32(s1, _mm256_madd_epi16(_mm256_maddubs_epi16(x, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + inputs + i))), ones));
+            s2 = _mm256_add_epi32(s2, _mm256_madd_epi16(_mm256_maddubs_epi16(x, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + 2 * inputs + i))), ones));
+            s3 = _mm256_add_epi32(s3, _mm256_madd_epi16(_mm256_maddubs_epi16(x, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + 3 * inputs + i))), ones));
+        }
+        __m256i lanes = _mm256_hadd_epi32(_mm256_hadd_epi32(s0, s1), _mm256_hadd_epi32(s2, s3)); // row totals per 128 bit lane
+        __m128i sums = _mm_add_epi32(_mm256_castsi256_si128(lanes), _mm256_extracti128_si256(lanes, 1));
+        sums = _mm_add_epi32(sums, _mm_loadu_si128(reinterpret_cast<const __m128i*>(bias + o)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), sums);
+    }
+    for (; o < outputs; o++) {
+        __m256i sum = dotAvx2(in, weights + o * inputs, inputs);
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+        out[o] = bias[o] + _mm_cvtsi128_si32(half);
+    }
+}
+
+static const NnueKernels sse41Kernels = {"sse4.1", addSubSse41, transformSse41, affineSse41};
+static const NnueKernels avx2Kernels = {"avx2", addSubAvx2, transformAvx2, affineAvx2};
+#endif
+
+static vector<const NnueKernels*> supportedKernels() { // fastest first
+    vector<const NnueKernels*> list;
+#ifdef NNUE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) list.push_back(&avx2Kernels);
+    if (__builtin_cpu_supports("sse4.1")) list.push_back(&sse41Kernels);
+#endif
+    list.push_back(&scalarKernels);
+    return list;
+}
+
+static const NnueKernels* kernels = &scalarKernels;
+
+static void releaseNetwork(Network& n) {
+    if (!n.base) return;
+#if defined(__unix__) || defined(__APPLE__)
+    if (n.mapped) munmap(n.base, n.bytes);
+    else free(n.base);
+#else
+    free(n.base);
+#endif
+    n = Network();
+}
+
+bool nnueLoad(const string& path) {
+    NetworkLayout layout = networkLayout();
+    NnueHeader header;
+    {
+        ifstream in(path, ios::binary);
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+    }
+    if (memcmp(header.magic, "CENN", 4) || header.version != 1 || header.features != NNUE_FEATURES || header.hidden != NNUE_HIDDEN
+        || header.l1 != NNUE_L1 || header.l2 != NNUE_L2 || header.outputScale <= 0) return false;
+
+    Network loaded;
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && size_t(st.st_size) >= layout.bytes) {
+        void* p = mmap(nullptr, layout.bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            loaded.base = p;
+            loaded.mapped = true;
+            madvise(p, layout.bytes, MADV_WILLNEED); // every evaluation reads weights all over the file
+        }
+    }
+    close(fd);
+#else
+    ifstream in(path, ios::binary);
+    loaded.base = malloc(layout.bytes);
+    if (loaded.base && !in.read(static_cast<char*>(loaded.base), layout.bytes)) {
+        free(loaded.base);
+        loaded.base = nullptr;
+    }
+#endif
+    if (!loaded.base) return false;
+    loaded.bytes = layout.bytes;
+
+    const char* base = static_cast<const char*>(loaded.base);
+    loaded.ftBias = reinterpret_cast<const int16_t*>(base + layout.offsets[FT_BIAS]);
+    loaded.ftWeights = reinterpret_cast<const int16_t*>(base + layout.offsets[FT_WEIGHTS]);
+    loaded.l1Bias = reinterpret_cast<const int32_t*>(base + layout.offsets[L1_BIAS]);
+    loaded.l1Weights = reinterpret_cast<const int8_t*>(base + layout.offsets[L1_WEIGHTS]);
+    loaded.l2Bias = reinterpret_cast<const int32_t*>(base + layout.offsets[L2_BIAS]);
+    loaded.l2Weights = reinterpret_cast<const int8_t*>(base + layout.offsets[L2_WEIGHTS]);
+    loaded.outBias = reinterpret_cast<const int32_t*>(base + layout.offsets[OUT_BIAS]);
+    loaded.outWeights = reinterpret_cast<const int8_t*>(base + layout.offsets[OUT_WEIGHTS]);
+    loaded.outputScale = header.outputScale;
+
+    releaseNetwork(net);
+    net = loaded;
+    kernels = supportedKernels().front();
+    return true;
+}
+
+bool nnueLoaded() {
+    return net.base != nullptr;
+}
+
+const char* nnueKernel() {
+    return kernels->name;
+}
+
+static const int16_t* featureRow(int perspective, int king, int piece, int sq) {
+    if (perspective == BLACK) { // black sees the board from its own side
+        king ^= 56;
+        sq ^= 56;
+    }
+    int kind = 2 * typeOf(piece) + (colorOf(piece) != perspective); // own pawn, their pawn, own knight, ...
+    return net.ftWeights + size_t((king * 10 + kind) * 64 + sq) * NNUE_HIDDEN;
+}
+
+static void refreshAccumulator(Position& pos, int perspective) {
+    int16_t* acc = pos.accumulator.values[perspective];
+    memcpy(acc, net.ftBias, sizeof(int16_t) * NNUE_HIDDEN);
+    int king = pos.kingSquare(perspective);
+    for (Bitboard b = pos.occupied & ~(pos.pieces[W_KING] | pos.pieces[B_KING]); b; ) {
+        int sq = popLsb(b);
+        kernels->addSub(acc, featureRow(perspective, king, pos.pieceOn(sq), sq), nullptr);
+    }
+    pos.accumulator.stale[perspective] = false;
+}
+
+void nnueUpdate(Position& pos, int piece, int removed, int added) {
+    if (typeOf(piece) == KING) { // every feature of this side changes, rebuild it when it is next read
+        pos.accumulator.stale[colorOf(piece)] = true;
+        return;
+    }
+    for (int perspective = WHITE; perspective <= BLACK; perspective++) {
+        if (pos.accumulator.stale[perspective]) continue;
+        int king = pos.kingSquare(perspective);
+        kernels->addSub(pos.accumulator.values[perspective],
+                        added == NO_SQUARE ? nullptr : featureRow(perspective, king, piece, added),
+                        removed == NO_SQUARE ? nullptr : featureRow(perspective, king, piece, removed));
+    }
+}
+
+static void activate(const int32_t* sums, uint8_t* out, int n) { // weights are scaled by 64
+    for (int i = 0; i < n; i++) out[i] = uint8_t(min(127, max(0, sums[i] >> 6)));
+}
+
+int nnueEvaluate(Position& pos) {
+    for (int perspective = WHITE; perspective <= BLACK; perspective++) {
+        if (pos.accumulator.stale[perspective]) refreshAccumulator(pos, perspective);
+    }
+    alignas(64) uint8_t input[2 * NNUE_HIDDEN];
+    alignas(64) int32_t sums[max(NNUE_L1, NNUE_L2)];
+    alignas(64) uint8_t hidden1[NNUE_L1];
+    alignas(64) uint8_t hidden2[NNUE_L2];
+    int32_t output;
+
+    int us = pos.sideToMove;
+    kernels->transform(pos.accumulator.values[us], input); // side to move first
+    kernels->transform(pos.accumulator.values[us ^ 1], input + NNUE_HIDDEN);
+    kernels->affine(input, net.l1Weights, net.l1Bias, sums, 2 * NNUE_HIDDEN, NNUE_L1);
+    activate(sums, hidden1, NNUE_L1);
+    kernels->affine(hidden1, net.l2Weights, net.l2Bias, sums, NNUE_L1, NNUE_L2);
+    activate(sums, hidden2, NNUE_L2);
+    kernels->affine(hidden2, net.outWeights, net.outBias, &output, NNUE_L2, 1);
+    return output / net.outputScale;
+}
+
+// Writes a network that reproduces Position::psqt, the material and piece-square part of
+// immediateEvaluation, as a known-good starting point for training and a check of the pipeline.
+// Pawn structure, the castled bonus and the opening center term depend on more than where single
+// pieces stand and are left out, so the network differs from the full evaluation by those.
+// For each side the accumulator holds 8 x its count of each piece type and the sum of its
+// square bonuses; both hidden layers pass those through and the output weighs them. There is
+// no rounding: every term of the output is a multiple of outputScale, and no slot reaches the
+// clip at 127 below 16 pieces of one type or with the current bonus tables.
+static bool exportNetwork(const string& path) {
+    NetworkLayout layout = networkLayout();
+    vector<char> file(layout.bytes, 0);
+    NnueHeader header = {};
+    memcpy(header.magic, "CENN", 4);
+    header.version = 1;
+    header.features = NNUE_FEATURES;
+    header.hidden = NNUE_HIDDEN;
+    header.l1 = NNUE_L1;
+    header.l2 = NNUE_L2;
+    header.outputScale = 8;
+    strncpy(header.description, "material and piece-square terms", sizeof(header.description) - 1);
+    memcpy(file.data(), &header, sizeof(header));
+
+    const int BONUS = KING; // accumulator slot of the square bonuses, after one slot per piece type
+    int base[KING];         // value of each piece type on its worst square
+    for (int type = PAWN; type < KING; type++) {
+        base[type] = *min_element(pieceSquareValue[makePiece(WHITE, type)], pieceSquareValue[makePiece(WHITE, type)] + 64);
+    }
+    int16_t* ftWeights = reinterpret_cast<int16_t*>(file.data() + layout.offsets[FT_WEIGHTS]);
+    for (int king = 0; king < 64; king++) {
+        for (int type = PAWN; type < KING; type++) {
+            for (int sq = 0; sq < 64; sq++) { // own pieces only, the other half of the input covers the opponent
+                int16_t* row = ftWeights + size_t((king * 10 + 2 * type) * 64 + sq) * NNUE_HIDDEN;
+                row[type] = 8;
+                row[BONUS] = int16_t(pieceSquareValue[makePiece(WHITE, type)][sq] - base[type]);
+            }
+        }
+    }
+    int8_t* l1Weights = reinterpret_cast<int8_t*>(file.data() + layout.offsets[L1_WEIGHTS]);
+    int8_t* l2Weights = reinterpret_cast<int8_t*>(file.data() + layout.offsets[L2_WEIGHTS]);
+    int8_t* outWeights = reinterpret_cast<int8_t*>(file.data() + layout.offsets[OUT_WEIGHTS]);
+    for (int i = 0; i <= BONUS; i++) {
+        int them = BONUS + 1 + i;
+        l1Weights[i * 2 * NNUE_HIDDEN + i] = 64; // 64 / 2^6 passes the input through
+        l1Weights[them * 2 * NNUE_HIDDEN + NNUE_HIDDEN + i] = 64;
+        l2Weights[i * NNUE_L1 + i] = 64;
+        l2Weights[them * NNUE_L1 + them] = 64;
+        int weight = i == BONUS ? 8 : base[i];
+        outWeights[i] = int8_t(weight);
+        outWeights[them] = int8_t(-weight);
+    }
+
+    ofstream out(path, ios::binary);
+    return bool(out.write(file.data(), file.size()));
+}
+
+int nnueCommand(int argc, char* argv[]) {
+    string usage = "usage: chess nnue export <file> | chess nnue eval <file> <fen>\n";
+    if (argc < 3) {
+        cout << usage;
+        return 1;
+    }
+    string mode = argv[1];
+    string path = argv[2];
+    initBitboards();
+
+    if (mode == "export") {
+        if (!exportNetwork(path)) {
+            cout << "Cannot write " << path << "\n";
+            return 1;
+        }
+        cout << "Wrote " << path << " (" << networkLayout().bytes << " bytes)\n";
+        return 0;
+    }
+    if (mode == "eval" && argc > 3) {
+        string fen;
+        for (int i = 3; i < argc; i++) fen += string(argv[i]) + " ";
+        Position pos;
+        if (!pos.setFromFen(fen)) {
+            cout << "Invalid FEN: " << fen << "\n";
+            return 1;
+        }
+        if (!nnueLoad(path)) {
+            cout << "Cannot load network " << path << "\n";
+            return 1;
+        }
+        int classic = immediateEvaluation(pos);
+        cout << "classic " << (pos.sideToMove == WHITE ? classic : -classic) << "\n";
+        cout << "psqt " << (pos.sideToMove == WHITE ? pos.psqt : -pos.psqt) << " (what the exported network reproduces)\n";
+        const NnueKernels* selected = kernels;
+        for (const NnueKernels* k : supportedKernels()) { // every kernel this machine runs must agree
+            kernels = k;
+            pos.invalidateAccumulator();
+            cout << k->name << " " << nnueEvaluate(pos) << (k == selected ? " (selected)" : "") << "\n";
+        }
+        kernels = selected;
+        return 0;
+    }
+    cout << usage;
+    return 1;
+}
@@ -0,0 +1,40 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Optional neural evaluation. The input layer is HalfKP: for each side, one feature per
+// (own king square, non-king piece, square), seen from that side with black's board flipped.
+// Its output, the accumulator, is kept in Position and updated by every piece change; a side's
+// half is rebuilt from scratch only after its own king moved. The rest of the network is
+// 2 x NNUE_HIDDEN -> NNUE_L1 -> NNUE_L2 -> 1 with clipped ReLUs in int8 arithmetic.
+const int NNUE_FEATURES = 64 * 10 * 64;
+const int NNUE_HIDDEN = 256;
+const int NNUE_L1 = 32;
+const int NNUE_L2 = 32;
+
+struct alignas(64) Accumulator {
+    int16_t values[2][NNUE_HIDDEN]; // by perspective, biases included
+    bool stale[2];                  // this perspective has to be rebuilt before it is read
+};
+
+class Position;
+
+extern bool nnueEnabled; // search evaluates with the network, only ever set while one is loaded
+
+bool nnueLoad(const std::string& path); // maps a network file, false (and the old one kept) if unusable
+bool nnueLoaded();
+const char* nnueKernel();               // instruction set picked at runtime: "avx2", "sse4.1" or "scalar"
+
+void nnueUpdate(Position& pos, int piece, int removed, int added); // either square may be NO_SQUARE
+int nnueEvaluate(Position& pos); // side to move's point of view, same scale as immediateEvaluation
+
+// chess nnue export <file> writes a network equal to the psqt term of the evaluation
+// chess nnue eval <file> <fen> prints the evaluation, its psqt term and what every kernel computes
+int nnueCommand(int argc, char* argv[]);
@@ -0,0 +1,160 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "omp.h"
+#include "movegen.h"
+#include "perft.h"
+#include "timer.h"
+
+using namespace std;
+
+struct PerftCase {
+    const char* name;
+    const char* fen;
+    uint64_t expected[6]; // depths 1..6, 0 when not listed
+};
+
+// reference counts from the Chess Programming Wiki perft results page
+static const PerftCase perftSuite[] = {
+    {"startpos", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        {20, 400, 8902, 197281, 4865609, 119060324}},
+    {"kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        {48, 2039, 97862, 4085603, 193690690, 0}},
+    {"position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        {14, 191, 2812, 43238, 674624, 11030083}},
+    {"position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        {6, 264, 9467, 422333, 15833292, 0}},
+    {"position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        {44, 1486, 62379, 2103487, 89941194, 0}},
+    {"position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+        {46, 2079, 89890, 3894594, 164075551, 0}},
+};
+
+uint64_t perft(Position& pos, int depth) {
+    MoveList moves;
+    enumerateAllMoves(pos, moves);
+    if (depth == 1) return moves.size(); // bulk count: the generator is legal, so the last ply is never entered
+    uint64_t nodes = 0;
+    for (Move m : moves) {
+        UndoInfo undo;
+        pos.makeMove(m, undo);
+        nodes += perft(pos, depth - 1);
+        pos.unmakeMove(m, undo);
+    }
+    return nodes;
+}
+
+static void perftRootMoves(const Position& root, int depth, int threads, const MoveList& moves, uint64_t counts[]) {
+    #pragma omp parallel num_threads(max(1, threads))
+    {
+        Position pos = root; // every thread walks its own copy
+        #pragma omp for schedule(dynamic, 1)
+        for (int i = 0; i < moves.size(); i++) {
+            UndoInfo undo;
+            pos.makeMove(moves[i], undo);
+            counts[i] = depth == 1 ? 1 : perft(pos, depth - 1);
+            pos.unmakeMove(moves[i], undo);
+        }
+    }
+}
+
+uint64_t parallelPerft(const Position& root, int depth, int threads) {
+    if (depth <= 0) return 1;
+    MoveList moves;
+    uint64_t counts[MAX_MOVES];
+    enumerateAllMoves(root, moves);
+    perftRootMoves(root, depth, threads, moves, counts);
+    uint64_t nodes = 0;
+    for (int i = 0; i < moves.size(); i++) nodes += counts[i];
+    return nodes;
+}
+
+static void printRate(uint64_t nodes, long long ms) {
+    cout << "Time: " << ms << " ms, " << nodes * 1000 / max(1LL, ms) << " nodes/s\n";
+}
+
+static int runSuite(int maxDepth, int threads) {
+    int failures = 0;
+    uint64_t totalNodes = 0;
+    Timer total;
+    total.start();
+    for (const PerftCase& test : perftSuite) {
+        Position pos;
+        pos.setFromFen(test.fen);
+        cout << test.name << "  " << test.fen << "\n";
+        for (int depth = 1; depth <= min(maxDepth, 6); depth++) {
+            if (!test.expected[depth - 1]) break;
+            Timer timer;
+            timer.start();
+            uint64_t nodes = parallelPerft(pos, depth, threads);
+            timer.stop();
+            bool ok = nodes == test.expected[depth - 1];
+            failures += !ok;
+            totalNodes += nodes;
+            cout << "  depth " << depth << "  expected " << test.expected[depth - 1] << "  actual " << nodes
+                 << (ok ? "  ok  " : "  FAIL  ") << timer.getMilliseconds() << " ms  "
+                 << nodes * 1000 / max(1LL, timer.getMilliseconds()) << " nodes/s\n";
+        }
+    }
+    total.stop();
+    cout << "\n" << (failures ? to_string(failures) + " failed" : string("all passed")) << ", " << totalNodes << " nodes\n";
+    printRate(totalNodes, total.getMilliseconds());
+    return failures ? 1 : 0;
+}
+
+int perftCommand(int argc, char* argv[]) {
+    string mode = argv[0];
+    int threads = omp_get_max_threads();
+    vector<string> args;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) threads = max(1, stoi(argv[++i]));
+        else args.push_back(arg);
+    }
+
+    initBitboards();
+    if (mode == "perft" && !args.empty() && args[0] == "suite") {
+        return runSuite(args.size() > 1 ? stoi(args[1]) : 5, threads);
+    }
+    if (args.empty()) {
+        cout << "usage: chess perft <depth> [fen] | chess divide <depth> [fen] | chess perft suite [max depth]\n";
+        return 1;
+    }
+
+    int depth = stoi(args[0]);
+    string fen;
+    for (size_t i = 1; i < args.size(); i++) fen += (i > 1 ? " " : "") + args[i];
+    Position pos;
+    if (!pos.setFromFen(fen.empty() ? string(START_FEN) : fen)) {
+        cout << "Invalid FEN: " << fen << "\n";
+        return 1;
+    }
+
+    Timer timer;
+    uint64_t nodes = 0;
+    timer.start();
+    if (mode == "divide") { // per root move counts, for finding which branch disagrees with a reference
+        MoveList moves;
+        uint64_t counts[MAX_MOVES];
+        enumerateAllMoves(pos, moves);
+        if (depth > 0) perftRootMoves(pos, depth, threads, moves, counts);
+        timer.stop();
+        for (int i = 0; i < moves.size(); i++) {
+            cout << moveToString(moves[i]) << ": " << (depth > 0 ? counts[i] : 1) << "\n";
+            nodes += depth > 0 ? counts[i] : 1;
+        }
+        cout << "\nMoves: " << moves.size() << "\n";
+    } else {
+        nodes = parallelPerft(pos, depth, threads);
+        timer.stop();
+    }
+    cout << "Nodes: " << nodes << "\n";
+    printRate(nodes, timer.getMilliseconds());
+    return 0;
+}
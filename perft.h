@@ -0,0 +1,16 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include "position.h"
+
+uint64_t perft(Position& pos, int depth); // number of legal move sequences of the given length
+uint64_t parallelPerft(const Position& root, int depth, int threads); // root moves split across threads
+
+// chess perft <depth> [fen] | chess divide <depth> [fen] | chess perft suite [max depth]
+int perftCommand(int argc, char* argv[]);
@@ -0,0 +1,341 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include <cstring>
+#include <sstream>
+#include "evaluate.h"
+#include "position.h"
+
+using namespace std;
+
+uint64_t zobristPieces[12][64];
+uint64_t zobristCastling[16];
+uint64_t zobristEnPassant[8];
+uint64_t zobristSide;
+
+static int castlingMask[64]; // rights that survive a move touching each square
+
+static struct PositionTablesInit {
+    PositionTablesInit() {
+        uint64_t state = 0x2545F4914F6CDD1DULL; // fixed seed so hashes are reproducible between runs
+        auto next = [&state]() { // xorshift64*
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return state * 2685821657736338717ULL;
+        };
+        for (auto& piece : zobristPieces) for (uint64_t& k : piece) k = next();
+        zobristCastling[0] = 0;
+        for (int i = 1; i < 16; i++) zobristCastling[i] = next();
+        for (uint64_t& k : zobristEnPassant) k = next();
+        zobristSide = next();
+
+        for (int sq = 0; sq < 64; sq++) castlingMask[sq] = 15;
+        castlingMask[E1] &= ~(WHITE_OO | WHITE_OOO);
+        castlingMask[H1] &= ~WHITE_OO;
+        castlingMask[A1] &= ~WHITE_OOO;
+        castlingMask[E8] &= ~(BLACK_OO | BLACK_OOO);
+        castlingMask[H8] &= ~BLACK_OO;
+        castlingMask[A8] &= ~BLACK_OOO;
+    }
+} positionTablesInit;
+
+void Position::clear() {
+    for (int i = 0; i < 12; i++) pieces[i] = 0;
+    colors[WHITE] = colors[BLACK] = 0;
+    occupied = 0;
+    for (int sq = 0; sq < 64; sq++) mailbox[sq] = NO_PIECE;
+    sideToMove = WHITE;
+    castlingRights = 0;
+    epSquare = NO_SQUARE;
+    halfmoveClock = 0;
+    fullmoveNumber = 1;
+    castled[WHITE] = castled[BLACK] = false;
+    key = 0;
+    psqt = 0;
+    pawnScore = 0;
+    invalidateAccumulator();
+}
+
+void Position::setStartPosition() { // place default pieces on board
+    const int backRank[8] = {ROOK, KNIGHT, BISHOP, QUEEN, KING, BISHOP, KNIGHT, ROOK};
+    clear();
+    for (int f = 0; f < 8; f++) {
+        putPiece(makePiece(WHITE, backRank[f]), makeSquare(0, f));
+        putPiece(W_PAWN, makeSquare(1, f));
+        putPiece(B_PAWN, makeSquare(6, f));
+        putPiece(makePiece(BLACK, backRank[f]), makeSquare(7, f));
+    }
+    castlingRights = WHITE_OO | WHITE_OOO | BLACK_OO | BLACK_OOO;
+    key = computeKey();
+    refreshEvaluation();
+}
+
+bool Position::setFromFen(const string& fenString) {
+    istringstream in(fenString);
+    string placement, side, castling, ep;
+    clear();
+    if (!(in >> placement >> side)) return false;
+    if (!(in >> castling)) castling = "-";
+    if (!(in >> ep)) ep = "-";
+    if (!(in >> halfmoveClock)) halfmoveClock = 0;
+    if (!(in >> fullmoveNumber)) fullmoveNumber = 1;
+
+    int rank = 7, file = 0;
+    for (char c : placement) {
+        if (c == '/') {
+            rank--;
+            file = 0;
+        } else if (c >= '1' && c <= '8') {
+            file += c - '0';
+        } else {
+            const char* p = strchr(pieceChars, c);
+            if (!p || c == '.' || rank < 0 || file > 7) {
+                clear();
+                return false;
+            }
+            putPiece(int(p - pieceChars), makeSquare(rank, file++));
+        }
+    }
+    if (rank != 0 || popCount(pieces[W_KING]) != 1 || popCount(pieces[B_KING]) != 1 || (side != "w" && side != "b")) {
+        clear();
+        return false;
+    }
+    sideToMove = side == "w" ? WHITE : BLACK;
+
+    for (char c : castling) { // rights are only kept when king and rook are still at home
+        if (c == 'K' && mailbox[E1] == W_KING && mailbox[H1] == W_ROOK) castlingRights |= WHITE_OO;
+        if (c == 'Q' && mailbox[E1] == W_KING && mailbox[A1] == W_ROOK) castlingRights |= WHITE_OOO;
+        if (c == 'k' && mailbox[E8] == B_KING && mailbox[H8] == B_ROOK) castlingRights |= BLACK_OO;
+        if (c == 'q' && mailbox[E8] == B_KING && mailbox[A8] == B_ROOK) castlingRights |= BLACK_OOO;
+    }
+    if (ep.size() == 2 && ep[0] >= 'a' && ep[0] <= 'h' && (ep[1] == '3' || ep[1] == '6')) {
+        int sq = makeSquare(ep[1] - '1', ep[0] - 'a');
+        if (pawnAttackTable[sideToMove ^ 1][sq] & byType(sideToMove, PAWN)) epSquare = sq; // same rule as makeMove
+    }
+    if (fullmoveNumber < 1) fullmoveNumber = 1;
+
+    key = computeKey();
+    refreshEvaluation();
+    return true;
+}
+
+string Position::fen() const {
+    string s;
+    for (int rank = 7; rank >= 0; rank--) {
+        int empty = 0;
+        for (int file = 0; file < 8; file++) {
+            int piece = mailbox[makeSquare(rank, file)];
+            if (piece == NO_PIECE) {
+                empty++;
+                continue;
+            }
+            if (empty) s += char('0' + empty);
+            empty = 0;
+            s += pieceChars[piece];
+        }
+        if (empty) s += char('0' + empty);
+        if (rank) s += '/';
+    }
+    s += sideToMove == WHITE ? " w " : " b ";
+    if (castlingRights & WHITE_OO) s += 'K';
+    if (castlingRights & WHITE_OOO) s += 'Q';
+    if (castlingRights & BLACK_OO) s += 'k';
+    if (castlingRights & BLACK_OOO) s += 'q';
+    if (!castlingRights) s += '-';
+    s += " " + (epSquare == NO_SQUARE ? string("-") : squareName(epSquare));
+    s += " " + to_string(halfmoveClock) + " " + to_string(fullmoveNumber);
+    return s;
+}
+
+void Position::refreshEvaluation() {
+    psqt = 0;
+    for (int sq = 0; sq < 64; sq++) {
+        if (mailbox[sq] != NO_PIECE) psqt += pieceSquareValue[mailbox[sq]][sq];
+    }
+    pawnScore = pawnStructure(pieces[W_PAWN], pieces[B_PAWN]);
+    invalidateAccumulator();
+}
+
+uint64_t Position::computeKey() const {
+    uint64_t k = 0;
+    for (int sq = 0; sq < 64; sq++) {
+        if (mailbox[sq] != NO_PIECE) k ^= zobristPieces[mailbox[sq]][sq];
+    }
+    k ^= zobristCastling[castlingRights];
+    if (epSquare != NO_SQUARE) k ^= zobristEnPassant[fileOf(epSquare)];
+    if (sideToMove == BLACK) k ^= zobristSide;
+    return k;
+}
+
+void Position::makeMove(Move m, UndoInfo& undo) {
+    int us = sideToMove;
+    int from = m.from();
+    int to = m.to();
+    int piece = mailbox[from];
+
+    undo.key = key;
+    undo.pawnScore = pawnScore;
+    undo.captured = NO_PIECE;
+    undo.castlingRights = castlingRights;
+    undo.epSquare = epSquare;
+    undo.halfmoveClock = halfmoveClock;
+
+    halfmoveClock++;
+    if (epSquare != NO_SQUARE) key ^= zobristEnPassant[fileOf(epSquare)];
+    epSquare = NO_SQUARE;
+
+    if (m.flags() == EN_PASSANT) { // captured pawn sits behind the target square
+        int capturedSquare = to + (us == WHITE ? -8 : 8);
+        undo.captured = mailbox[capturedSquare];
+        removePiece(capturedSquare);
+    } else if (m.isCapture()) {
+        undo.captured = mailbox[to];
+        removePiece(to);
+        halfmoveClock = 0;
+    }
+    movePiece(from, to);
+
+    if (typeOf(piece) == PAWN) {
+        halfmoveClock = 0;
+        if (m.flags() == DOUBLE_PUSH && (pawnAttackTable[us][(from + to) / 2] & byType(us ^ 1, PAWN))) {
+            epSquare = (from + to) / 2; // only recorded when an enemy pawn can actually take en passant
+            key ^= zobristEnPassant[fileOf(epSquare)];
+        }
+        if (m.isPromotion()) {
+            removePiece(to);
+            putPiece(makePiece(us, m.promotionType()), to);
+        }
+    } else if (m.isCastle()) { // king already moved, bring the rook over
+        int rank = us == WHITE ? 0 : 7;
+        if (m.flags() == KING_CASTLE) movePiece(makeSquare(rank, 7), makeSquare(rank, 5));
+        else movePiece(makeSquare(rank, 0), makeSquare(rank, 3));
+        castled[us] = true;
+    }
+
+    key ^= zobristCastling[castlingRights];
+    castlingRights &= castlingMask[from] & castlingMask[to];
+    key ^= zobristCastling[castlingRights] ^ zobristSide;
+    if (typeOf(piece) == PAWN || (undo.captured != NO_PIECE && typeOf(undo.captured) == PAWN)) {
+        pawnScore = pawnStructure(pieces[W_PAWN], pieces[B_PAWN]);
+    }
+    if (us == BLACK) fullmoveNumber++;
+    sideToMove = us ^ 1;
+}
+
+void Position::unmakeMove(Move m, const UndoInfo& undo) {
+    int us = sideToMove ^ 1;
+    int from = m.from();
+    int to = m.to();
+
+    sideToMove = us;
+    if (us == BLACK) fullmoveNumber--;
+
+    if (m.isPromotion()) { // turn the promoted piece back into a pawn before moving it home
+        removePiece(to);
+        putPiece(makePiece(us, PAWN), to);
+    } else if (m.isCastle()) {
+        int rank = us == WHITE ? 0 : 7;
+        if (m.flags() == KING_CASTLE) movePiece(makeSquare(rank, 5), makeSquare(rank, 7));
+        else movePiece(makeSquare(rank, 3), makeSquare(rank, 0));
+        castled[us] = false;
+    }
+    movePiece(to, from);
+
+    if (m.flags() == EN_PASSANT) putPiece(undo.captured, to + (us == WHITE ? -8 : 8));
+    else if (m.isCapture()) putPiece(undo.captured, to);
+
+    castlingRights = undo.castlingRights;
+    epSquare = undo.epSquare;
+    halfmoveClock = undo.halfmoveClock;
+    key = undo.key;
+    pawnScore = undo.pawnScore;
+}
+
+void Position::makeNullMove(UndoInfo& undo) {
+    undo.key = key;
+    undo.pawnScore = pawnScore;
+    undo.captured = NO_PIECE;
+    undo.castlingRights = castlingRights;
+    undo.epSquare = epSquare;
+    undo.halfmoveClock = halfmoveClock;
+
+    halfmoveClock++;
+    if (epSquare != NO_SQUARE) key ^= zobristEnPassant[fileOf(epSquare)];
+    epSquare = NO_SQUARE;
+    key ^= zobristSide;
+    sideToMove ^= 1;
+}
+
+void Position::unmakeNullMove(const UndoInfo& undo) {
+    sideToMove ^= 1;
+    epSquare = undo.epSquare;
+    halfmoveClock = undo.halfmoveClock;
+    key = undo.key;
+}
+
+Bitboard Position::attackersTo(int sq, Bitboard occ) const {
+    return (pawnAttackTable[BLACK][sq] & pieces[W_PAWN])
+         | (pawnAttackTable[WHITE][sq] & pieces[B_PAWN])
+         | (knightAttackTable[sq] & (pieces[W_KNIGHT] | pieces[B_KNIGHT]))
+         | (kingAttackTable[sq] & (pieces[W_KING] | pieces[B_KING]))
+         | (bishopAttacks(sq, occ) & (pieces[W_BISHOP] | pieces[B_BISHOP] | pieces[W_QUEEN] | pieces[B_QUEEN]))
+         | (rookAttacks(sq, occ) & (pieces[W_ROOK] | pieces[B_ROOK] | pieces[W_QUEEN] | pieces[B_QUEEN]));
+}
+
+bool Position::isAttacked(int sq, int byColor) const {
+    return (pawnAttackTable[byColor ^ 1][sq] & byType(byColor, PAWN))
+        || (knightAttackTable[sq] & byType(byColor, KNIGHT))
+        || (kingAttackTable[sq] & byType(byColor, KING))
+        || (bishopAttacks(sq, occupied) & (byType(byColor, BISHOP) | byType(byColor, QUEEN)))
+        || (rookAttacks(sq, occupied) & (byType(byColor, ROOK) | byType(byColor, QUEEN)));
+}
+
+bool Position::seeGE(Move m, int threshold) const {
+    if (m.isCastle() || m.isPromotion() || m.flags() == EN_PASSANT) return 0 >= threshold; // not worth modelling
+
+    int from = m.from();
+    int to = m.to();
+    int swap = (mailbox[to] == NO_PIECE ? 0 : seeValues[typeOf(mailbox[to])]) - threshold;
+    if (swap < 0) return false; // even winning the target outright is not enough
+    swap = seeValues[typeOf(mailbox[from])] - swap;
+    if (swap <= 0) return true; // even losing the mover is fine
+
+    // Alternate recaptures with the least valuable attacker, uncovering x-ray attackers as pieces leave.
+    Bitboard occ = occupied ^ squareBit(from) ^ squareBit(to);
+    Bitboard diagonal = pieces[W_BISHOP] | pieces[B_BISHOP] | pieces[W_QUEEN] | pieces[B_QUEEN];
+    Bitboard straight = pieces[W_ROOK] | pieces[B_ROOK] | pieces[W_QUEEN] | pieces[B_QUEEN];
+    Bitboard attackers = attackersTo(to, occ);
+    int stm = colorOf(mailbox[from]);
+    int result = 1;
+
+    while (true) {
+        stm ^= 1;
+        attackers &= occ;
+        Bitboard stmAttackers = attackers & colors[stm];
+        if (!stmAttackers) break;
+        result ^= 1;
+
+        int type = PAWN;
+        while (!(stmAttackers & byType(stm, type))) type++;
+        if (type == KING) { // the king may only recapture if nothing defends the square any more
+            return (attackers & colors[stm ^ 1]) ? result ^ 1 : result;
+        }
+        swap = seeValues[type] - swap;
+        if (swap < result) break;
+
+        occ ^= squareBit(lsb(stmAttackers & byType(stm, type)));
+        if (type == PAWN || type == BISHOP || type == QUEEN) attackers |= bishopAttacks(to, occ) & diagonal;
+        if (type == ROOK || type == QUEEN) attackers |= rookAttacks(to, occ) & straight;
+    }
+    return result;
+}
+
+string moveToString(Move m) {
+    string s = squareName(m.from()) + squareName(m.to());
+    if (m.isPromotion()) s += "nbrq"[m.promotionType() - KNIGHT];
+    return s;
+}
@@ -0,0 +1,130 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+#include <string>
+#include "bitboard.h"
+#include "move.h"
+#include "nnue.h"
+
+enum Color { WHITE, BLACK };
+enum PieceType { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING };
+enum Piece {
+    W_PAWN, W_KNIGHT, W_BISHOP, W_ROOK, W_QUEEN, W_KING,
+    B_PAWN, B_KNIGHT, B_BISHOP, B_ROOK, B_QUEEN, B_KING,
+    NO_PIECE
+};
+
+const char pieceChars[] = "PNBRQKpnbrqk.";
+
+inline int makePiece(int color, int type) { return color * 6 + type; }
+inline int colorOf(int piece) { return piece >= B_PAWN; }
+inline int typeOf(int piece) { return piece % 6; }
+
+enum CastlingRight { WHITE_OO = 1, WHITE_OOO = 2, BLACK_OO = 4, BLACK_OOO = 8 };
+
+extern uint64_t zobristPieces[12][64]; // random keys hashed into Position::key
+extern uint64_t zobristCastling[16];
+extern uint64_t zobristEnPassant[8];   // by file
+extern uint64_t zobristSide;           // black to move
+
+extern int pieceSquareValue[12][64];    // see evaluate.h
+
+struct UndoInfo { // state makeMove cannot recover on its own, kept by the caller
+    uint64_t key;
+    int pawnScore;
+    uint8_t captured;
+    uint8_t castlingRights;
+    uint8_t epSquare;
+    uint8_t halfmoveClock;
+};
+
+class Position {
+    public:
+        Bitboard pieces[12];   // one set per piece, indexed by Piece
+        Bitboard colors[2];    // all white / all black pieces
+        Bitboard occupied;
+        uint8_t mailbox[64];   // piece on each square, NO_PIECE when empty
+
+        int sideToMove;
+        int castlingRights;    // CastlingRight bits still available
+        int epSquare;          // square behind a pawn that just moved two, NO_SQUARE otherwise
+        int halfmoveClock;
+        int fullmoveNumber;
+        bool castled[2];       // whether each side has castled this game
+        uint64_t key;          // Zobrist hash, kept up to date by every board change
+        int psqt;              // material + piece-square evaluation, kept up to date by every board change
+        int pawnScore;         // pawn structure evaluation, recomputed only when pawns change
+        Accumulator accumulator; // network input layer, kept up to date while nnueEnabled
+
+        void clear();
+        void setStartPosition();
+        bool setFromFen(const std::string& fen); // false (and the position left cleared) if malformed
+        std::string fen() const;
+        uint64_t computeKey() const; // full recomputation of key, for setup and debugging
+        void refreshEvaluation();    // full recomputation of psqt and pawnScore, accumulator rebuilt on next use
+        void invalidateAccumulator() { accumulator.stale[WHITE] = accumulator.stale[BLACK] = true; }
+
+        void makeMove(Move m, UndoInfo& undo);
+        void unmakeMove(Move m, const UndoInfo& undo);
+        void makeNullMove(UndoInfo& undo); // pass the turn, for null move pruning; never while in check
+        void unmakeNullMove(const UndoInfo& undo);
+
+        void putPiece(int piece, int sq) {
+            Bitboard b = squareBit(sq);
+            pieces[piece] |= b;
+            colors[colorOf(piece)] |= b;
+            occupied |= b;
+            mailbox[sq] = piece;
+            key ^= zobristPieces[piece][sq];
+            psqt += pieceSquareValue[piece][sq];
+            if (nnueEnabled) nnueUpdate(*this, piece, NO_SQUARE, sq);
+        }
+        void removePiece(int sq) {
+            Bitboard b = squareBit(sq);
+            int piece = mailbox[sq];
+            pieces[piece] ^= b;
+            colors[colorOf(piece)] ^= b;
+            occupied ^= b;
+            mailbox[sq] = NO_PIECE;
+            key ^= zobristPieces[piece][sq];
+            psqt -= pieceSquareValue[piece][sq];
+            if (nnueEnabled) nnueUpdate(*this, piece, sq, NO_SQUARE);
+        }
+        void movePiece(int from, int to) { // to must be empty
+            int piece = mailbox[from];
+            Bitboard b = squareBit(from) | squareBit(to);
+            pieces[piece] ^= b;
+            colors[colorOf(piece)] ^= b;
+            occupied ^= b;
+            mailbox[from] = NO_PIECE;
+            mailbox[to] = piece;
+            key ^= zobristPieces[piece][from] ^ zobristPieces[piece][to];
+            psqt += pieceSquareValue[piece][to] - pieceSquareValue[piece][from];
+            if (nnueEnabled) nnueUpdate(*this, piece, from, to);
+        }
+
+        int pieceOn(int sq) const { return mailbox[sq]; }
+        Bitboard byType(int color, int type) const { return pieces[makePiece(color, type)]; }
+
+        int kingSquare(int color) const { return lsb(byType(color, KING)); }
+
+        Bitboard attackersTo(int sq, Bitboard occ) const; // pieces of both colors attacking sq
+        bool isAttacked(int sq, int byColor) const;
+        bool kingAttacked(int color) const { // also true when the king has been captured
+            return !byType(color, KING) || isAttacked(kingSquare(color), color ^ 1);
+        }
+        bool inCheck() const { return kingAttacked(sideToMove); }
+
+        bool seeGE(Move m, int threshold) const; // static exchange on the target square gains at least threshold
+};
+
+const int seeValues[6] = {10, 30, 30, 50, 90, 10000}; // exchange values by piece type, same scale as the evaluation
+
+const char START_FEN[] = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+std::string moveToString(Move m); // long algebraic, e.g. "e2e4" or "e7e8q"
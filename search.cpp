@@ -0,0 +1,642 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include "omp.h" // Include OpenMP for parallel processing. Need to install omp to build.
+#include "evaluate.h"
+#include "movegen.h"
+#include "nnue.h"
+#include "search.h"
+#include "tablebase.h"
+
+using namespace std;
+
+static const int pieceValues[6] = {1, 3, 3, 5, 9, 100}; // ordering values by piece type
+static const int DELTA_MARGIN = 20; // two pawns: a capture this far short of alpha cannot be saved by the position
+
+static int evaluate(SearchWorker& w) { // static score from the side to move's point of view
+    w.stats.evalCalls++;
+    PROFILE_SCOPE(w.stats.evalNs);
+    if (w.nnue) return nnueEvaluate(w.pos);
+    int evaluation = immediateEvaluation(w.pos);
+    return w.pos.sideToMove == WHITE ? evaluation : -evaluation;
+}
+
+static void generateMoves(SearchWorker& w, MoveList& moves, bool capturesOnly) {
+    w.stats.movegenCalls++;
+    PROFILE_SCOPE(w.stats.movegenNs);
+    if (capturesOnly) enumerateCaptures(w.pos, moves);
+    else enumerateAllMoves(w.pos, moves);
+}
+
+static void scoreMoves(const SearchWorker& w, const MoveList& moves, int scores[], int ply, Move ttMove) {
+    int us = w.pos.sideToMove;
+    for (int i = 0; i < moves.size(); i++) {
+        Move m = moves[i];
+        if (m == ttMove) { // best move from an earlier search of this position
+            scores[i] = 3000000;
+        } else if (m.isCapture()) { // MVV-LVA: most valuable victim first, cheapest attacker breaks ties
+            int victim = m.flags() == EN_PASSANT ? PAWN : typeOf(w.pos.pieceOn(m.to()));
+            int attacker = typeOf(w.pos.pieceOn(m.from()));
+            scores[i] = 2000000 + pieceValues[victim] * 100 - pieceValues[attacker];
+        } else if (m.isPromotion()) {
+            scores[i] = 1900000 + m.promotionType();
+        } else if (m == w.killers[ply][0]) {
+            scores[i] = 1800000;
+        } else if (m == w.killers[ply][1]) {
+            scores[i] = 1700000;
+        } else {
+            scores[i] = w.history[us][m.from()][m.to()];
+        }
+    }
+}
+
+static Move pickMove(MoveList& moves, int scores[], int i) { // selection sort one step, the rest rarely get looked at
+    int best = i;
+    for (int j = i + 1; j < moves.size(); j++) {
+        if (scores[j] > scores[best]) best = j;
+    }
+    swap(moves[i], moves[best]);
+    swap(scores[i], scores[best]);
+    return moves[i];
+}
+
+static void updatePv(SearchWorker& w, int ply, Move m) {
+    w.pv[ply][ply] = m;
+    for (int i = ply + 1; i < w.pvLength[ply + 1]; i++) w.pv[ply][i] = w.pv[ply + 1][i];
+    w.pvLength[ply] = max(w.pvLength[ply + 1], ply + 1);
+}
+
+static void updateQuietStats(SearchWorker& w, int ply, int depth, Move m) { // quiet move caused a beta cutoff
+    if (w.killers[ply][0] != m) {
+        w.killers[ply][1] = w.killers[ply][0];
+        w.killers[ply][0] = m;
+    }
+    int& h = w.history[w.pos.sideToMove][m.from()][m.to()];
+    h += depth * depth;
+    if (h > 1000000) { // keep history below the killer scores
+        for (auto& side : w.history) for (auto& from : side) for (int& to : from) to /= 2;
+    }
+}
+
+static bool hasPieces(const Position& pos, int color) { // anything besides pawns and king, so a pass is not the best move
+    return pos.byType(color, KNIGHT) | pos.byType(color, BISHOP) | pos.byType(color, ROOK) | pos.byType(color, QUEEN);
+}
+
+const SearchParameter searchParameters[] = {
+    {"NullMoveDepth", &SearchOptions::nullMoveDepth, 0, 64},
+    {"NullMoveReduction", &SearchOptions::nullMoveReduction, 1, 8},
+    {"LmrDepth", &SearchOptions::lmrDepth, 0, 64},
+    {"LmrMoves", &SearchOptions::lmrMoves, 1, 64},
+    {"LmrBase", &SearchOptions::lmrBase, 0, 300},
+    {"LmrDivisor", &SearchOptions::lmrDivisor, 50, 1000},
+    {"FutilityDepth", &SearchOptions::futilityDepth, 0, 16},
+    {"FutilityMargin", &SearchOptions::futilityMargin, 0, 100},
+    {"ReverseFutilityDepth", &SearchOptions::reverseFutilityDepth, 0, 16},
+    {"ReverseFutilityMargin", &SearchOptions::reverseFutilityMargin, 0, 100},
+    {"CheckExtension", &SearchOptions::checkExtension, 0, 1},
+};
+const int searchParameterCount = sizeof(searchParameters) / sizeof(searchParameters[0]);
+
+bool setSearchParameter(SearchOptions& options, const string& name, int value) {
+    for (const SearchParameter& p : searchParameters) {
+        if (name != p.name) continue;
+        options.*p.value = min(max(value, p.min), p.max);
+        return true;
+    }
+    return false;
+}
+
+Engine::Engine(size_t hashMegabytes, bool hugePages) {
+    options.threads = omp_get_max_threads();
+    tt.resize(hashMegabytes, hugePages);
+}
+
+void Engine::clear() {
+    tt.clear();
+    clearHistory();
+}
+
+void Engine::clearHistory() {
+    workers.clear(); // recreated with empty killers and history by the next search
+}
+
+// negamax alpha-beta with principal variation search, scores are from the side to move's point of view
+int Engine::enumerateMoveTree(SearchWorker& w, int depth, int ply, int alpha, int beta) {
+    w.pvLength[ply] = ply;
+    w.nodes++;
+    if (--w.checkCountdown <= 0) checkLimits(w);
+    if (stopped()) return 0; // unwinding an aborted search, the caller throws the score away
+    if (depth == 0) return quiescence(w, ply, alpha, beta); // base case, settle captures first
+    if (ply >= MAX_PLY - 1) return evaluate(w);
+
+    bool pvNode = beta - alpha > 1;
+    TTEntry entry;
+    Move ttMove;
+    w.stats.ttProbes++;
+    if (tt.probe(w.pos.key, entry)) {
+        w.stats.ttHits++;
+        ttMove = entry.move;
+        int ttScore = scoreFromTT(entry.score, ply);
+        if (!pvNode && entry.depth >= depth && (entry.bound == BOUND_EXACT
+                || (entry.bound == BOUND_LOWER && ttScore >= beta)
+                || (entry.bound == BOUND_UPPER && ttScore <= alpha))) {
+            return ttScore; // already searched at least this deep
+        }
+    }
+
+    if (popCount(w.pos.occupied) <= tbLargest()) { // the 2 bit tables are small enough to probe anywhere
+        int wdl;
+        if (tbProbeWdl(w.pos, wdl)) return wdl > 0 ? TB_WIN_SCORE - ply : wdl < 0 ? -TB_WIN_SCORE + ply : 0;
+    }
+
+    int us = w.pos.sideToMove;
+    bool inCheck = w.pos.inCheck();
+    int staticEval = inCheck ? -INFINITE_SCORE : evaluate(w);
+    bool nearMate = abs(alpha) >= TB_WIN_SCORE - MAX_PLY || abs(beta) >= TB_WIN_SCORE - MAX_PLY; // no guessing around mates
+    bool selective = !pvNode && !inCheck && !nearMate;
+
+    // Reverse futility: so far above beta that no quiet reply is going to bring it back.
+    if (selective && depth <= options.reverseFutilityDepth && staticEval - options.reverseFutilityMargin * depth >= beta) {
+        return staticEval;
+    }
+
+    // Null move: if passing still fails high, a real move will too. Not twice in a row, and not with only
+    // pawns left, where zugzwang makes passing better than any move.
+    if (selective && options.nullMoveDepth && depth >= options.nullMoveDepth && staticEval >= beta
+            && !w.nullMove[ply - 1] && hasPieces(w.pos, us)) {
+        int reduction = options.nullMoveReduction + depth / 6;
+        UndoInfo undo;
+        w.pos.makeNullMove(undo);
+        w.nullMove[ply] = true;
+        int score = -enumerateMoveTree(w, max(0, depth - 1 - reduction), ply + 1, -beta, -beta + 1);
+        w.nullMove[ply] = false;
+        w.pos.unmakeNullMove(undo);
+        if (stopped()) return 0;
+        if (score >= beta) return score >= TB_WIN_SCORE - MAX_PLY ? beta : score; // a mate found by passing proves nothing
+    }
+
+    MoveList moves;
+    int scores[MAX_MOVES];
+    generateMoves(w, moves, false); // get moves
+    if (moves.size() == 0) return inCheck ? -MATE_SCORE + ply : 0; // checkmate or stalemate
+    scoreMoves(w, moves, scores, ply, ttMove);
+
+    bool beam = options.beamPly > 0 && ply >= options.beamPly;
+    int legalMoves = 0;
+    int bestScore = -INFINITE_SCORE;
+    int originalAlpha = alpha;
+    Move bestMove;
+
+    for (int i = 0; i < moves.size(); i++) {
+        Move move = pickMove(moves, scores, i);
+        bool quiet = !move.isCapture() && !move.isPromotion();
+        UndoInfo undo;
+        w.pos.makeMove(move, undo); // make move
+        bool givesCheck = w.pos.inCheck();
+
+        // Futility: near the leaves a quiet move has to be worth a margin to lift the static eval above alpha.
+        int futilityValue = staticEval + options.futilityMargin * depth;
+        if (selective && quiet && !givesCheck && legalMoves > 0 && depth <= options.futilityDepth && futilityValue <= alpha) {
+            w.pos.unmakeMove(move, undo);
+            bestScore = max(bestScore, futilityValue);
+            continue;
+        }
+        tt.prefetch(w.pos.key);
+        legalMoves++;
+        int newDepth = depth - 1 + (givesCheck && ply < 2 * w.rootDepth ? options.checkExtension : 0);
+
+        int score;
+        if (legalMoves == 1) { // expected best move gets the full window
+            score = -enumerateMoveTree(w, newDepth, ply + 1, -beta, -alpha);
+        } else { // the rest only have to prove they are no better, late quiet moves at a reduced depth first
+            int reduction = 0;
+            if (quiet && !inCheck && !givesCheck && options.lmrDepth && depth >= options.lmrDepth && legalMoves > options.lmrMoves) {
+                reduction = reductions[min(depth, 63)][min(legalMoves, 63)];
+                if (pvNode) reduction--;
+                if (move == w.killers[ply][0] || move == w.killers[ply][1]) reduction--;
+                reduction = max(0, min(reduction, newDepth - 1));
+            }
+            score = -enumerateMoveTree(w, newDepth - reduction, ply + 1, -alpha - 1, -alpha);
+            if (score > alpha && reduction > 0 && !stopped()) {
+                score = -enumerateMoveTree(w, newDepth, ply + 1, -alpha - 1, -alpha);
+            }
+            if (score > alpha && score < beta && !stopped()) {
+                score = -enumerateMoveTree(w, newDepth, ply + 1, -beta, -alpha);
+            }
+        }
+        w.pos.unmakeMove(move, undo); // undo move
+        if (stopped()) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            if (score > alpha) {
+                alpha = score;
+                bestMove = move;
+                updatePv(w, ply, move);
+                if (alpha >= beta) {
+                    w.stats.betaCutoffs++;
+                    if (legalMoves == 1) w.stats.firstMoveCutoffs++;
+                    if (!move.isCapture() && !move.isPromotion()) updateQuietStats(w, ply, depth, move);
+                    break;
+                }
+            }
+        }
+        if (beam && legalMoves >= options.branches) break; // beam: only the best ordered moves get searched
+    }
+
+    int bound = bestScore >= beta ? BOUND_LOWER : bestScore > originalAlpha ? BOUND_EXACT : BOUND_UPPER;
+    tt.store(w.pos.key, bestMove, scoreToTT(bestScore, ply), depth, bound);
+    return bestScore;
+}
+
+// resolves captures and promotions until the position is quiet, so leaves are not scored mid-exchange
+int Engine::quiescence(SearchWorker& w, int ply, int alpha, int beta) {
+    w.pvLength[ply] = ply;
+    w.nodes++;
+    w.stats.qnodes++;
+    if (--w.checkCountdown <= 0) checkLimits(w);
+    if (stopped()) return 0;
+    if (ply >= MAX_PLY - 1) return evaluate(w);
+
+    // In check there is no standing pat: every evasion is searched so mates are still seen.
+    bool inCheck = w.pos.inCheck();
+    int bestScore = -INFINITE_SCORE;
+    int standPat = 0;
+    if (!inCheck) {
+        standPat = evaluate(w);
+        if (standPat >= beta) return standPat; // side to move may decline every capture
+        if (standPat > alpha) alpha = standPat;
+        bestScore = standPat;
+    }
+
+    MoveList moves;
+    int scores[MAX_MOVES];
+    generateMoves(w, moves, !inCheck);
+    if (inCheck && moves.size() == 0) return -MATE_SCORE + ply; // checkmate
+    scoreMoves(w, moves, scores, ply, Move());
+
+    for (int i = 0; i < moves.size(); i++) {
+        Move move = pickMove(moves, scores, i);
+        if (!inCheck) {
+            int victim = move.flags() == EN_PASSANT ? PAWN : typeOf(w.pos.pieceOn(move.to()));
+            int gain = move.isCapture() ? seeValues[victim] : 0;
+            if (move.isPromotion()) gain += seeValues[QUEEN] - seeValues[PAWN];
+            if (standPat + gain + DELTA_MARGIN <= alpha) continue; // delta pruning: even the whole gain is not enough
+            if (!move.isPromotion() && !w.pos.seeGE(move, 0)) continue; // loses material on the exchange
+        }
+
+        UndoInfo undo;
+        w.pos.makeMove(move, undo);
+        int score = -quiescence(w, ply + 1, -beta, -alpha);
+        w.pos.unmakeMove(move, undo);
+        if (stopped()) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            if (score > alpha) {
+                alpha = score;
+                updatePv(w, ply, move);
+                if (alpha >= beta) break;
+            }
+        }
+    }
+
+    return bestScore;
+}
+
+bool Engine::searchRoot(SearchWorker& w, MoveList& moves, int depth, int lineCount, SearchResult& result) {
+    const Position& root = w.pos;
+    w.rootDepth = depth;
+
+    TTEntry entry;
+    Move ttMove = tt.probe(root.key, entry) ? entry.move : Move(); // last iteration's best move, from any thread
+    int scores[MAX_MOVES];
+    scoreMoves(w, moves, scores, 0, ttMove);
+    for (int i = 0; i < moves.size(); i++) pickMove(moves, scores, i);
+    lineCount = min(max(1, lineCount), moves.size());
+    if (lineCount > 1) { // last iteration's lines go first, in their order
+        int front = 0;
+        for (const RootLine& line : result.lines) {
+            for (int i = front; i < moves.size(); i++) {
+                if (moves[i] != line.pv[0]) continue;
+                rotate(moves.begin() + front, moves.begin() + i, moves.begin() + i + 1);
+                front++;
+                break;
+            }
+        }
+    }
+    int helper = int(&w - workers.data()); // 0 for the main thread
+    if (helper && moves.size() > lineCount + 1) { // helpers start on different moves after the lines, so they fill different parts of the table
+        rotate(moves.begin() + lineCount, moves.begin() + lineCount + helper % (moves.size() - lineCount), moves.end());
+    }
+
+    // The first ordered move is searched with a full window to establish a bound. The others are
+    // searched with a null window against the worst of the lineCount best scores so far and only
+    // re-searched if they beat it, so every line kept has an exact score. Until there are lineCount
+    // lines every move is searched with a full window.
+    vector<RootLine> lines; // best first, side to move's point of view until the iteration ends
+    for (int i = 0; i < moves.size(); i++) {
+        bool full = int(lines.size()) < lineCount;
+        int alpha = full ? -INFINITE_SCORE : lines.back().score;
+        UndoInfo undo;
+        w.nodes++;
+        w.pos.makeMove(moves[i], undo); // make move
+        int score;
+        if (full) {
+            score = -enumerateMoveTree(w, depth - 1, 1, -INFINITE_SCORE, INFINITE_SCORE);
+        } else {
+            score = -enumerateMoveTree(w, depth - 1, 1, -alpha - 1, -alpha);
+            if (score > alpha && !stopped()) {
+                score = -enumerateMoveTree(w, depth - 1, 1, -INFINITE_SCORE, -alpha);
+            }
+        }
+        w.pos.unmakeMove(moves[i], undo); // undo move
+        if (stopped()) break; // aborted searches return meaningless scores
+        if (!full && score <= alpha) continue;
+
+        RootLine line; // beating the last line means beating the bound it was searched against, so the score is exact
+        line.score = score;
+        updatePv(w, 0, moves[i]);
+        line.pvLength = w.pvLength[0];
+        for (int j = 0; j < line.pvLength; j++) line.pv[j] = w.pv[0][j];
+        auto at = upper_bound(lines.begin(), lines.end(), score,
+                              [](int s, const RootLine& l) { return s > l.score; }); // after equal scores, the earlier move stays ahead
+        lines.insert(at, line);
+        if (int(lines.size()) > lineCount) lines.pop_back();
+    }
+    if (lines.empty()) return false; // nothing trustworthy from this iteration
+
+    int bestScore = lines[0].score;
+    if (!stopped()) tt.store(root.key, lines[0].pv[0], scoreToTT(bestScore, 0), depth, BOUND_EXACT);
+    for (RootLine& line : lines) {
+        if (root.sideToMove == BLACK) line.score = -line.score;
+    }
+    result.lines = lines;
+    result.bestMove = lines[0].pv[0];
+    result.score = lines[0].score;
+    result.pvLength = lines[0].pvLength;
+    for (int i = 0; i < result.pvLength; i++) result.pv[i] = lines[0].pv[i];
+    return true;
+}
+
+// Picks the root move straight from the distance to mate tables: the fastest mate when winning, any
+// drawing move when drawn, the slowest mate when lost. False if any position involved is missing.
+static bool probeRoot(const Position& root, const MoveList& moves, SearchResult& result) {
+    int rootWdl, rootPlies;
+    if (popCount(root.occupied) > tbLargest() || !tbProbeDtm(root, rootWdl, rootPlies)) return false;
+    rootPlies *= rootWdl; // signed: positive wins, negative losses
+    Position pos = root;
+    int bestPlies = 0;
+    Move best;
+    for (Move m : moves) {
+        UndoInfo undo;
+        pos.makeMove(m, undo);
+        int wdl, plies;
+        bool found = tbProbeDtm(pos, wdl, plies); // fails after a double push that allows en passant
+        pos.unmakeMove(m, undo);
+        if (!found) continue;
+        int ours = wdl < 0 ? plies + 1 : wdl > 0 ? -(plies + 1) : 0; // one ply further from mate, signed for us
+        bool better = best.isNone()
+            || (ours > 0 && (bestPlies <= 0 || ours < bestPlies))
+            || (ours == 0 && bestPlies < 0)
+            || (ours < 0 && bestPlies < 0 && ours < bestPlies);
+        if (better) {
+            best = m;
+            bestPlies = ours;
+        }
+    }
+    if (best.isNone() || bestPlies != rootPlies) return false; // a skipped move was the only way to get this result
+
+    int score = bestPlies > 0 ? MATE_SCORE - bestPlies : bestPlies < 0 ? -MATE_SCORE - bestPlies : 0;
+    result.bestMove = best;
+    result.score = root.sideToMove == WHITE ? score : -score;
+    result.depth = 1;
+    result.pv[0] = best;
+    result.pvLength = 1;
+    result.lines.assign(1, RootLine());
+    result.lines[0].score = result.score;
+    result.lines[0].pv[0] = best;
+    result.lines[0].pvLength = 1;
+    return true;
+}
+
+void Engine::allocateTime(const Position& root) {
+    softLimitNs = hardLimitNs = 0;
+    if (limits.infinite) return;
+
+    long long overhead = options.moveOverhead;
+    int us = root.sideToMove;
+    if (limits.movetime > 0) { // fixed time per move, use all of it
+        hardLimitNs = softLimitNs = max(1LL, limits.movetime - overhead) * 1000000;
+    } else if (limits.time[us] > 0) { // share the clock between the moves still to come
+        long long remaining = max(1LL, limits.time[us] - overhead);
+        int movesToGo = limits.movestogo > 0 ? min(limits.movestogo, 40) : 30;
+        long long maximum = max(1LL, min(remaining * 3 / 4, (remaining / movesToGo + limits.inc[us]) * 4));
+        long long optimum = min(maximum, remaining / movesToGo + limits.inc[us] * 3 / 4);
+        softLimitNs = optimum * 1000000;
+        hardLimitNs = maximum * 1000000;
+    }
+}
+
+void Engine::checkLimits(SearchWorker& w) {
+    int interval = 1024;
+    if (limits.nodes) interval = int(max<uint64_t>(1, min<uint64_t>(1024, limits.nodes / (64 * workers.size()))));
+    w.checkCountdown = interval;
+    uint64_t total = sharedNodes.fetch_add(interval, memory_order_relaxed) + interval;
+    if (limits.nodes && total >= limits.nodes) stop();
+    if (hardLimitNs && !pondering && timer.elapsedNanoseconds() >= hardLimitNs) stop();
+}
+
+void SearchStats::add(const SearchStats& other) {
+    qnodes += other.qnodes;
+    movegenCalls += other.movegenCalls;
+    evalCalls += other.evalCalls;
+    ttProbes += other.ttProbes;
+    ttHits += other.ttHits;
+    betaCutoffs += other.betaCutoffs;
+    firstMoveCutoffs += other.firstMoveCutoffs;
+    movegenNs += other.movegenNs;
+    evalNs += other.evalNs;
+}
+
+void Engine::collectStats(SearchResult& result) const {
+    result.nodes = 0;
+    result.stats = SearchStats();
+    result.threadNodes.clear();
+    for (const SearchWorker& w : workers) {
+        result.nodes += w.nodes;
+        result.stats.add(w.stats);
+        result.threadNodes.push_back(w.nodes);
+    }
+    result.positionsEvaluated = result.stats.evalCalls;
+    result.timeMs = timer.elapsedMilliseconds();
+}
+
+void Engine::prepare(const Position& root, const SearchLimits& searchLimits) {
+    timer.start();
+    limits = searchLimits;
+    sharedNodes = 0;
+    if (int(workers.size()) != max(1, options.threads)) workers = vector<SearchWorker>(max(1, options.threads));
+    for (SearchWorker& w : workers) {
+        w.pos = root;
+        w.pos.invalidateAccumulator(); // root may have been set up while the network was off
+        w.nodes = 0;
+        w.stats = SearchStats();
+        w.checkCountdown = 0;
+        w.nnue = nnueEnabled && options.useNnue;
+    }
+    allocateTime(root);
+    for (int d = 0; d < 64; d++) {
+        for (int m = 0; m < 64; m++) {
+            double r = d && m ? (options.lmrBase + log(d) * log(m) * 10000 / options.lmrDivisor) / 100 : 0;
+            reductions[d][m] = uint8_t(min(63.0, r));
+        }
+    }
+}
+
+SearchResult Engine::search(const Position& root, const SearchLimits& searchLimits) {
+    prepare(root, searchLimits);
+    tt.newSearch();
+    // Lazy SMP: the helper threads run the same iterative deepening on their own, odd ones a ply
+    // ahead, and share nothing but the hash table, where their results speed up the main thread.
+    // Only the main thread's result counts; it stops the helpers when it is done.
+    SearchResult result;
+    #pragma omp parallel num_threads(int(workers.size()))
+    {
+        int id = omp_get_thread_num();
+        if (id == 0) {
+            result = iterativeDeepening(root);
+            stop();
+        } else {
+            helperSearch(workers[id]);
+        }
+    }
+    collectStats(result);
+    if (!options.statsFile.empty()) {
+        ofstream out(options.statsFile, ios::app);
+        out << searchStatsJson(result) << '\n';
+    }
+    return result;
+}
+
+bool Engine::searchMove(const Position& root, Move m, int depth, int alpha, int beta, SearchResult& result) {
+    prepare(root, SearchLimits());
+    SearchWorker& w = workers[0]; // the other workers stay idle
+    w.rootDepth = depth;
+    UndoInfo undo;
+    w.nodes++;
+    w.pos.makeMove(m, undo);
+    int score = -enumerateMoveTree(w, depth - 1, 1, -beta, -alpha);
+    w.pos.unmakeMove(m, undo);
+    updatePv(w, 0, m);
+
+    result = SearchResult();
+    result.bestMove = m;
+    result.score = root.sideToMove == WHITE ? score : -score;
+    result.depth = depth;
+    result.pvLength = w.pvLength[0];
+    for (int i = 0; i < result.pvLength; i++) result.pv[i] = w.pv[0][i];
+    collectStats(result);
+    return !stopped();
+}
+
+SearchResult Engine::iterativeDeepening(const Position& root) {
+    SearchResult result;
+    MoveList moves;
+    enumerateAllMoves(root, moves);
+    if (moves.size() == 0) { // checkmate or stalemate
+        int sign = root.sideToMove == WHITE ? 1 : -1;
+        result.score = root.inCheck() ? -sign * MATE_SCORE : 0;
+        return result;
+    }
+    result.bestMove = moves[0]; // something to play even if the first iteration is cut short
+    if (probeRoot(root, moves, result)) {
+        collectStats(result);
+        if (onIteration) onIteration(result);
+        return result;
+    }
+
+    int maxDepth = limits.depth > 0 ? min(limits.depth, MAX_PLY - 1) : MAX_PLY - 1;
+    int stableIterations = 0;
+    for (int depth = 1; depth <= maxDepth; depth++) { // iterative deepening
+        Move previousBest = result.bestMove;
+        SearchResult iteration = result;
+        bool finished = searchRoot(workers[0], moves, depth, options.multiPV, iteration);
+        // An aborted iteration still counts moves it fully searched, but only once it has as many lines
+        // as the last one: fewer would replace complete lines with a partial list.
+        if (finished && (!stopped() || int(iteration.lines.size()) >= min(max(1, options.multiPV), moves.size()))) {
+            result = iteration;
+            result.depth = depth;
+        }
+        if (!finished || stopped()) break;
+
+        collectStats(result);
+        result.iterations.push_back({depth, result.nodes, result.timeMs});
+        if (onIteration) onIteration(result);
+
+        int mateDistance = MATE_SCORE - abs(result.score);
+        if (!limits.infinite && options.multiPV <= 1 && mateDistance <= MAX_PLY && depth >= mateDistance) break; // cannot find a faster mate
+
+        stableIterations = result.bestMove == previousBest ? stableIterations + 1 : 0;
+        if (softLimitNs && !pondering) { // spend less time when the best move keeps agreeing with itself, more when it just changed
+            double scale = stableIterations >= 3 ? 0.6 : (stableIterations == 0 && depth > 4 ? 1.5 : 1.0);
+            if (timer.elapsedNanoseconds() >= softLimitNs * scale) break;
+        }
+    }
+    return result;
+}
+
+void Engine::helperSearch(SearchWorker& w) {
+    MoveList moves;
+    enumerateAllMoves(w.pos, moves);
+    if (moves.size() == 0) return;
+    int helper = int(&w - workers.data());
+    int maxDepth = limits.depth > 0 ? min(limits.depth + 1, MAX_PLY - 1) : MAX_PLY - 1;
+    SearchResult scratch; // thrown away, the table keeps what was learned
+    for (int depth = 1 + helper % 2; depth <= maxDepth && !stopped(); depth++) { // as many lines as the main thread, so both search the same tree
+        searchRoot(w, moves, depth, options.multiPV, scratch);
+    }
+}
+
+static double fraction(uint64_t part, uint64_t whole) {
+    return whole ? double(part) / double(whole) : 0.0;
+}
+
+string searchStatsJson(const SearchResult& r) {
+    const SearchStats& s = r.stats;
+    ostringstream out;
+    out.setf(ios::fixed);
+    out.precision(4);
+    // Effective branching factor: nodes of the last iteration over nodes of the one before.
+    size_t n = r.iterations.size();
+    uint64_t last = n >= 1 ? r.iterations[n - 1].nodes - (n >= 2 ? r.iterations[n - 2].nodes : 0) : 0;
+    uint64_t previous = n >= 2 ? r.iterations[n - 2].nodes - (n >= 3 ? r.iterations[n - 3].nodes : 0) : 0;
+
+    out << "{\"depth\":" << r.depth << ",\"time_ms\":" << r.timeMs << ",\"nodes\":" << r.nodes
+        << ",\"qnodes\":" << s.qnodes << ",\"nps\":" << r.nodes * 1000 / uint64_t(max(1LL, r.timeMs))
+        << ",\"movegen_calls\":" << s.movegenCalls << ",\"eval_calls\":" << s.evalCalls
+        << ",\"tt_probes\":" << s.ttProbes << ",\"tt_hits\":" << s.ttHits << ",\"tt_hit_rate\":" << fraction(s.ttHits, s.ttProbes)
+        << ",\"beta_cutoffs\":" << s.betaCutoffs << ",\"first_move_cutoff_rate\":" << fraction(s.firstMoveCutoffs, s.betaCutoffs)
+        << ",\"ebf\":" << fraction(last, previous);
+#ifdef CHESS_PROFILE
+    out << ",\"movegen_ms\":" << s.movegenNs / 1e6 << ",\"eval_ms\":" << s.evalNs / 1e6;
+#endif
+    out << ",\"thread_nodes\":[";
+    for (size_t i = 0; i < r.threadNodes.size(); i++) out << (i ? "," : "") << r.threadNodes[i];
+    out << "],\"iterations\":[";
+    for (size_t i = 0; i < n; i++) {
+        out << (i ? "," : "") << "{\"depth\":" << r.iterations[i].depth << ",\"nodes\":" << r.iterations[i].nodes
+            << ",\"time_ms\":" << r.iterations[i].timeMs << "}";
+    }
+    out << "]}";
+    return out.str();
+}
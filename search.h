@@ -0,0 +1,170 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "move.h"
+#include "position.h"
+#include "timer.h"
+#include "tt.h"
+
+const int INFINITE_SCORE = 10000000;
+const int MATE_SCORE = 1000000; // mate in n plies scores MATE_SCORE - n
+const int MAX_PLY = 128;
+const int TB_WIN_SCORE = MATE_SCORE - 2 * MAX_PLY; // tablebase win with no known distance, below every real mate
+
+struct SearchOptions {
+    int threads = 1;
+    int branches = 10;     // moves searched per node once the beam is active
+    int beamPly = 0;       // first ply where only the top `branches` ordered moves are searched, 0 disables
+    int moveOverhead = 30; // ms kept back from every clock allocation for I/O and GUI lag
+    int multiPV = 1;       // root moves searched to an exact score and reported, best first
+    bool useNnue = true;   // evaluate with the network while nnueEnabled, false keeps this engine on the classic evaluation
+    std::string statsFile; // every search appends one line of searchStatsJson here, empty for none
+
+    // Selective search, depths in plies and margins in evaluation units (pawn = 10). 0 turns a technique off.
+    int nullMoveDepth = 3;          // null move pruning from this depth on
+    int nullMoveReduction = 3;      // plies the null move search is reduced by, one more for every 6 plies of depth
+    int lmrDepth = 3;               // late move reductions from this depth on
+    int lmrMoves = 3;               // moves searched at full depth before later quiet moves are reduced
+    int lmrBase = 75;               // reduction = (lmrBase + 100 * ln(depth) * ln(move number) * 100 / lmrDivisor) / 100
+    int lmrDivisor = 225;
+    int futilityDepth = 3;          // quiet moves that cannot lift the static eval to alpha are skipped up to this depth
+    int futilityMargin = 12;        // per ply of depth
+    int reverseFutilityDepth = 6;   // nodes whose static eval beats beta by the margin return at once up to this depth
+    int reverseFutilityMargin = 10; // per ply of depth
+    int checkExtension = 1;         // plies added to moves that give check
+};
+
+struct SearchParameter { // the selective search settings by name, for UCI options and the match harness
+    const char* name;
+    int SearchOptions::* value;
+    int min, max;
+};
+extern const SearchParameter searchParameters[];
+extern const int searchParameterCount;
+bool setSearchParameter(SearchOptions& options, const std::string& name, int value); // false for an unknown name
+
+struct SearchLimits { // all zero means search until stop()
+    int depth = 0;
+    uint64_t nodes = 0;
+    long long movetime = 0; // ms for this move
+    long long time[2] = {0, 0}; // remaining clock per color, ms
+    long long inc[2] = {0, 0};
+    int movestogo = 0;
+    bool infinite = false;
+};
+
+struct SearchStats { // counted per thread without any sharing, summed when the search ends
+    uint64_t qnodes = 0;           // quiescence nodes, also included in nodes
+    uint64_t movegenCalls = 0;
+    uint64_t evalCalls = 0;
+    uint64_t ttProbes = 0;         // main search only
+    uint64_t ttHits = 0;
+    uint64_t betaCutoffs = 0;      // main search only
+    uint64_t firstMoveCutoffs = 0; // cutoffs by the first move tried, a measure of move ordering
+    uint64_t movegenNs = 0;        // phase times, only measured in CHESS_PROFILE builds
+    uint64_t evalNs = 0;
+
+    void add(const SearchStats& other);
+};
+
+struct IterationStats {
+    int depth;
+    uint64_t nodes;  // all threads, since the search started
+    long long timeMs;
+};
+
+struct alignas(64) SearchWorker { // everything one search thread writes, padded so threads never share a cache line
+    Position pos;
+    uint64_t nodes = 0;
+    SearchStats stats;
+    int checkCountdown = 0;       // nodes until this thread next polls the clock and node budget
+    bool nnue = false;            // evaluate with the network, fixed for the whole search
+    bool nullMove[MAX_PLY] = {};  // the move from this ply to the next is a null move
+    int rootDepth = 0;            // depth of the current iteration
+
+    Move killers[MAX_PLY][2];     // last two quiet moves that caused a cutoff at each ply
+    int history[2][64][64] = {};  // [color][from][to] cutoff history for quiet moves
+    Move pv[MAX_PLY][MAX_PLY];    // triangular principal variation table
+    int pvLength[MAX_PLY] = {};
+};
+
+struct RootLine { // one MultiPV line
+    int score = 0; // positive favors white, exact
+    Move pv[MAX_PLY];
+    int pvLength = 0;
+};
+
+struct SearchResult {
+    Move bestMove;           // none when the side to move has no legal moves
+    int score = 0;           // positive favors white
+    int depth = 0;           // iteration the lines come from, the last one may have been cut short
+    Move pv[MAX_PLY];
+    int pvLength = 0;
+    uint64_t nodes = 0;
+    uint64_t positionsEvaluated = 0;
+    long long timeMs = 0;
+    SearchStats stats;                     // all threads
+    std::vector<uint64_t> threadNodes;     // per thread, main thread first
+    std::vector<IterationStats> iterations; // completed iterations in order
+    std::vector<RootLine> lines;           // the best options.multiPV root moves, lines[0] is bestMove and pv
+};
+
+std::string searchStatsJson(const SearchResult& r); // one line, for tracking performance across builds
+
+class Engine {
+    public:
+        SearchOptions options;
+        TranspositionTable tt;
+        std::function<void(const SearchResult&)> onIteration; // called after every completed iteration
+        // Thinking on the opponent's time: no clock limit applies while set. The caller sets it before
+        // starting the search (so a quick ponderhit cannot be lost) and clears it on every other search.
+        std::atomic<bool> pondering{false};
+
+        Engine(size_t hashMegabytes = 64, bool hugePages = false);
+
+        // Arms a search: clears an earlier stop(). Call it on the thread that starts the search, before
+        // starting it, so a stop() sent right after is never lost.
+        void newSearch() { stopRequested = false; }
+        SearchResult search(const Position& root, const SearchLimits& limits); // blocks until a limit or stop(), call newSearch() first
+        // One root move searched to a fixed depth with the window (alpha, beta) from the root side's point
+        // of view, for callers that split the root among processes themselves (chess cluster). Single
+        // threaded and without time limits; the hash table is not aged, call tt.newSearch() per position.
+        // result gets the move's score (positive favors white, only a bound outside the window), its
+        // line and the node count. False if stop() cut it short. Call newSearch() first.
+        bool searchMove(const Position& root, Move m, int depth, int alpha, int beta, SearchResult& result);
+        void stop() { stopRequested = true; } // safe to call from any thread
+        void ponderhit() { pondering = false; } // the predicted move was played, the clock now runs from the search start
+        void clear();                          // forget everything learned, e.g. for a new game
+        void clearHistory();                   // killers and history only, the hash table is kept
+
+    private:
+        std::vector<SearchWorker> workers;
+        std::atomic<bool> stopRequested{false};
+        std::atomic<uint64_t> sharedNodes{0}; // nodes published by all threads, for the node budget
+        SearchLimits limits;
+        Timer timer;
+        long long softLimitNs = 0; // no new iteration once this is used (scaled by best move stability)
+        long long hardLimitNs = 0; // abort mid-iteration
+        uint8_t reductions[64][64]; // late move reduction by depth and move number, from the options
+
+        void prepare(const Position& root, const SearchLimits& limits); // resets the workers, clock and reduction table
+        SearchResult iterativeDeepening(const Position& root);
+        void collectStats(SearchResult& result) const; // sums the workers' counters into result
+        void allocateTime(const Position& root);
+        void checkLimits(SearchWorker& w);
+        bool stopped() const { return stopRequested.load(std::memory_order_relaxed); }
+        bool searchRoot(SearchWorker& w, MoveList& moves, int depth, int lineCount, SearchResult& result); // false if aborted before any move finished
+        void helperSearch(SearchWorker& w); // Lazy SMP helper, runs until stop()
+        int enumerateMoveTree(SearchWorker& w, int depth, int ply, int alpha, int beta);
+        int quiescence(SearchWorker& w, int ply, int alpha, int beta); // captures only, below the horizon
+};
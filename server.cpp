@@ -0,0 +1,326 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "movegen.h"
+#include "search.h"
+#include "server.h"
+#include "timer.h"
+#include "uci.h"
+
+using namespace std;
+
+const size_t maxPendingOutput = 1 << 20; // a client this far behind on reading is disconnected
+
+struct Session { // one connected game
+    int fd;                   // non-blocking, -1 once closed, only changed under writeLock
+    int wakeFd;               // written to wake the I/O thread when output is left for it to flush
+    mutex writeLock;          // replies come from the I/O thread and from whichever engine searches for us
+    string output;            // replies the socket did not take yet, guarded by writeLock
+    string input;             // received bytes not yet ending in a newline, I/O thread only
+    Position position;        // I/O thread only
+    bool busy = false;        // a search is queued or running; this and the next two are guarded by Server::lock
+    Engine* engine = nullptr; // the pool engine running our search
+    long long searchNs = 0;   // search time used so far, decides who is served next
+
+    Session(int socket, int wake) : fd(socket), wakeFd(wake) { position.setStartPosition(); }
+};
+
+struct SearchJob {
+    shared_ptr<Session> session;
+    Position root;
+    SearchLimits limits;
+    Timer queued; // started when the go arrived
+};
+
+struct Server {
+    mutex lock;
+    condition_variable jobReady;
+    vector<SearchJob> pending;
+    long long maxMovetime = 10000;
+};
+
+static void flushOutput(Session& s) { // caller holds writeLock; sends what the socket takes without waiting
+    size_t sent = 0;
+    while (sent < s.output.size()) {
+        ssize_t n = send(s.fd, s.output.data() + sent, s.output.size() - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break; // full, or broken and the I/O thread notices when it reads
+        sent += size_t(n);
+    }
+    s.output.erase(0, sent);
+}
+
+static void sendLine(Session& s, const string& line) { // never blocks, so a slow client cannot stall a search or the I/O thread
+    lock_guard<mutex> lock(s.writeLock);
+    if (s.fd < 0) return;
+    bool queued = !s.output.empty();
+    s.output += line + "\n";
+    if (!queued) flushOutput(s); // keep the order: only the I/O thread sends behind queued output
+    if (s.output.size() > maxPendingOutput) {
+        s.output.clear();
+        shutdown(s.fd, SHUT_RDWR); // the I/O thread sees the end of the stream and closes the session
+    } else if (!queued && !s.output.empty()) {
+        char wake = 0;
+        if (write(s.wakeFd, &wake, 1) < 0) {} // a full pipe already has the I/O thread on its way
+    }
+}
+
+static void applyBudget(SearchJob& job, long long maxMovetime) {
+    SearchLimits& l = job.limits;
+    job.queued.stop();
+    long long waited = job.queued.getMilliseconds();
+    int us = job.root.sideToMove;
+    l.infinite = false;
+    if (l.time[us] > 0) { // the client's clock kept running while we were queued
+        l.time[us] = max(1LL, l.time[us] - waited);
+        return;
+    }
+    if (l.movetime > 0) l.movetime = max(1LL, l.movetime - waited);
+    if (maxMovetime > 0) l.movetime = l.movetime > 0 ? min(l.movetime, maxMovetime) : maxMovetime;
+}
+
+static void poolWorker(Server& server, size_t hashMegabytes) {
+    Engine engine(hashMegabytes);
+    engine.options.threads = 1; // the pool is the parallelism
+    while (true) {
+        SearchJob job;
+        {
+            unique_lock<mutex> lock(server.lock);
+            server.jobReady.wait(lock, [&] { return !server.pending.empty(); });
+            size_t next = 0;
+            for (size_t i = 1; i < server.pending.size(); i++) { // least served first, then oldest
+                if (server.pending[i].session->searchNs < server.pending[next].session->searchNs) next = i;
+            }
+            job = move(server.pending[next]);
+            server.pending.erase(server.pending.begin() + next);
+            job.session->engine = &engine;
+            engine.newSearch(); // under the lock, so a stop from now on reaches this search
+        }
+        applyBudget(job, server.maxMovetime);
+        Session& session = *job.session;
+        const Position& root = job.root;
+        engine.onIteration = [&](const SearchResult& r) { sendLine(session, infoString(r, root, engine)); };
+        Timer timer;
+        timer.start();
+        SearchResult result = engine.search(root, job.limits);
+        timer.stop();
+        {
+            lock_guard<mutex> lock(server.lock);
+            session.searchNs += timer.getNanoseconds();
+            session.engine = nullptr;
+            session.busy = false;
+        }
+        string line = "bestmove " + (result.bestMove.isNone() ? string("0000") : moveToString(result.bestMove));
+        if (result.pvLength > 1) line += " ponder " + moveToString(result.pv[1]);
+        sendLine(session, line);
+    }
+}
+
+static void stopSession(Server& server, const shared_ptr<Session>& session) { // drops a queued search, stops a running one
+    bool dropped = false;
+    {
+        lock_guard<mutex> lock(server.lock);
+        for (size_t i = 0; i < server.pending.size(); i++) {
+            if (server.pending[i].session != session) continue;
+            server.pending.erase(server.pending.begin() + i);
+            session->busy = false;
+            dropped = true;
+            break;
+        }
+        if (session->engine) session->engine->stop();
+    }
+    if (dropped) sendLine(*session, "bestmove 0000"); // every go gets its bestmove
+}
+
+static bool handleLine(Server& server, const shared_ptr<Session>& session, const string& line) { // false on quit
+    istringstream in(line);
+    string command;
+    in >> command;
+    if (command == "position") {
+        Position pos;
+        string error;
+        if (!parsePosition(in, pos, error)) {
+            sendLine(*session, "error " + error);
+            if (pos.occupied == 0) return true; // nothing usable, keep the old position
+        }
+        session->position = pos;
+    } else if (command == "go") {
+        bool ponder;
+        SearchJob job;
+        job.limits = parseGo(in, ponder);
+        if (ponder) {
+            sendLine(*session, "error go ponder is not supported by the server");
+            return true;
+        }
+        job.session = session;
+        job.root = session->position;
+        job.queued.start();
+        lock_guard<mutex> lock(server.lock);
+        if (session->busy) {
+            sendLine(*session, "error search in progress");
+            return true;
+        }
+        session->busy = true;
+        server.pending.push_back(move(job));
+        server.jobReady.notify_one();
+    } else if (command == "stop") {
+        stopSession(server, session);
+    } else if (command == "isready") {
+        sendLine(*session, "readyok");
+    } else if (command == "d") {
+        sendLine(*session, session->position.fen());
+    } else if (command == "quit") {
+        return false;
+    } else if (!command.empty()) {
+        sendLine(*session, "error unknown command " + command);
+    }
+    return true;
+}
+
+static void closeSession(Server& server, const shared_ptr<Session>& session) {
+    stopSession(server, session);
+    lock_guard<mutex> lock(session->writeLock); // an engine may still be about to reply
+    flushOutput(*session); // last chance for replies to quit, anything the socket will not take is lost
+    close(session->fd);
+    session->fd = -1;
+}
+
+static int openListener(int port, const string& socketPath) {
+    int fd;
+    if (!socketPath.empty()) {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (socketPath.size() >= sizeof(address.sun_path)) return -1;
+        strcpy(address.sun_path, socketPath.c_str());
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        unlink(socketPath.c_str()); // left behind by an earlier run
+        if (fd < 0 || bind(fd, (sockaddr*)&address, sizeof(address)) < 0) return -1;
+    } else {
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(uint16_t(port));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // local clients only
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        if (fd >= 0) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        if (fd < 0 || bind(fd, (sockaddr*)&address, sizeof(address)) < 0) return -1;
+    }
+    if (listen(fd, 64) < 0) return -1;
+    return fd;
+}
+
+int serverCommand(int argc, char* argv[]) {
+    int port = 7878;
+    string socketPath;
+    int workerCount = max(1u, thread::hardware_concurrency());
+    size_t hashMegabytes = 16;
+    Server server;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--port" && i + 1 < argc) {
+            port = stoi(argv[++i]);
+        } else if (arg == "--socket" && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (arg == "--workers" && i + 1 < argc) {
+            workerCount = max(1, stoi(argv[++i]));
+        } else if (arg == "--hash" && i + 1 < argc) {
+            hashMegabytes = stoul(argv[++i]);
+        } else if (arg == "--max-movetime" && i + 1 < argc) { // 0 lets unclocked searches run to their depth or node limit
+            server.maxMovetime = max(0LL, stoll(argv[++i]));
+        } else {
+            cerr << "usage: chess server [--port N | --socket path] [--workers N] [--hash MB] [--max-movetime ms]\n";
+            return 1;
+        }
+    }
+
+    initBitboards();
+    int listener = openListener(port, socketPath);
+    if (listener < 0) {
+        cerr << "cannot listen on " << (socketPath.empty() ? "port " + to_string(port) : socketPath) << ": " << strerror(errno) << "\n";
+        return 1;
+    }
+    int wake[2]; // engines write a byte to wake poll when they leave output behind
+    if (pipe(wake) < 0) {
+        cerr << "cannot create pipe: " << strerror(errno) << "\n";
+        return 1;
+    }
+    fcntl(wake[0], F_SETFL, O_NONBLOCK);
+    fcntl(wake[1], F_SETFL, O_NONBLOCK);
+    for (int i = 0; i < workerCount; i++) thread(poolWorker, ref(server), hashMegabytes).detach(); // they live as long as the process
+    cout << "listening on " << (socketPath.empty() ? "127.0.0.1:" + to_string(port) : socketPath) << " with "
+         << workerCount << " engines" << endl;
+
+    // One thread reads every connection and sends whatever output the sockets could not take at
+    // once; searching and replying to go happen on the pool.
+    map<int, shared_ptr<Session>> sessions;
+    vector<pollfd> fds;
+    char buffer[4096];
+    while (true) {
+        fds.assign({{listener, POLLIN, 0}, {wake[0], POLLIN, 0}});
+        for (auto& entry : sessions) {
+            lock_guard<mutex> lock(entry.second->writeLock);
+            fds.push_back({entry.first, short(POLLIN | (entry.second->output.empty() ? 0 : POLLOUT)), 0});
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd >= 0) {
+                fcntl(fd, F_SETFL, O_NONBLOCK);
+                sessions[fd] = make_shared<Session>(fd, wake[1]);
+            }
+        }
+        if (fds[1].revents & POLLIN) {
+            while (read(wake[0], buffer, sizeof(buffer)) > 0) {}
+        }
+        for (size_t i = 2; i < fds.size(); i++) {
+            if (!fds[i].revents) continue;
+            shared_ptr<Session> session = sessions[fds[i].fd];
+            if (fds[i].revents & POLLOUT) {
+                lock_guard<mutex> lock(session->writeLock);
+                flushOutput(*session);
+            }
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            ssize_t n = recv(fds[i].fd, buffer, sizeof(buffer), 0);
+            bool open = n > 0 || (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR));
+            if (n > 0) session->input.append(buffer, size_t(n));
+            size_t end;
+            while (open && (end = session->input.find('\n')) != string::npos) {
+                string line = session->input.substr(0, end);
+                session->input.erase(0, end + 1);
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                open = handleLine(server, session, line);
+            }
+            if (!open) {
+                sessions.erase(fds[i].fd);
+                closeSession(server, session);
+            }
+        }
+    }
+    close(listener);
+    return 1;
+}
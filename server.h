@@ -0,0 +1,21 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+// Serves many games from one process. Clients connect to a loopback TCP port or a Unix socket, one
+// game per connection, and speak a line protocol borrowed from UCI:
+//     position startpos|fen <fen> [moves ...]
+//     go [wtime|btime|winc|binc|movestogo|depth|nodes|movetime N ...]  answered by info lines and bestmove
+//     stop, isready, d (prints the FEN), quit
+// Problems are reported as "error <reason>". Searches from every session queue for one pool of
+// engines, each with its own hash table and move ordering history, so the memory per game is just
+// its position. A free engine takes the queued search of the session that has had the least search
+// time so far. Time spent in the queue comes off the session's clock or movetime, and searches
+// without a clock are capped so no session can hold an engine indefinitely. Sockets never block:
+// replies a client is slow to read wait in a buffer, and a client over 1 MB behind is disconnected.
+// chess server [--port N | --socket path] [--workers N] [--hash MB per worker] [--max-movetime ms]
+int serverCommand(int argc, char* argv[]);
@@ -0,0 +1,576 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+#include "omp.h" // Include OpenMP for parallel processing. Need to install omp to build.
+#include "movegen.h"
+#include "tablebase.h"
+#include "timer.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static const char pieceLetters[] = "PNBRQ";
+static const int materialValues[5] = {1, 3, 3, 5, 9};
+static const int triangleSquares[10] = {A1, B1, C1, D1, B2, C2, D2, C3, D3, D4}; // white king of a pawnless table
+static const uint8_t ILLEGAL = 255;
+static const int NO_WIN = 256;
+
+// An entry is 0 for a draw (or an illegal placement) and otherwise the plies to mate plus one, so
+// odd values mean the side to move gets mated and even values mean it mates.
+struct TbHeader { // start of every file, the packed entries follow
+    char magic[4];  // "CETB"
+    uint8_t version;
+    uint8_t bits;    // per entry
+    uint8_t maxCode; // largest entry in the file
+    uint8_t pieces;
+    char name[8];
+    uint64_t entries;
+};
+
+struct TableLayout {
+    string name;                  // e.g. "KBNK": white pieces after the first K, black after the second
+    int pieceCount = 0;           // kings included
+    int pieces[TB_MAX_PIECES];    // Piece in each slot, the two kings first
+    bool pawns = false;           // pawnless tables also use the diagonal and vertical symmetries
+    uint64_t entries = 0;
+};
+
+struct Table {
+    TableLayout layout;
+    string path;                  // without extension
+    mutex mapLock;
+    atomic<const unsigned char*> data[2] = {{nullptr}, {nullptr}}; // wdl, dtm
+    int bits[2] = {2, 0};
+    bool failed[2] = {false, false};
+    vector<pair<void*, size_t>> mappings;
+
+    ~Table() {
+#if defined(__unix__) || defined(__APPLE__)
+        for (auto& m : mappings) munmap(m.first, m.second);
+#else
+        for (auto& m : mappings) free(m.first);
+#endif
+    }
+};
+
+static map<uint64_t, unique_ptr<Table>> tables; // by material key, stronger side as white
+static int largestTable = 0;
+
+static void materialCounts(const Position& pos, int count[2][5]) {
+    for (int c = WHITE; c <= BLACK; c++) {
+        for (int t = PAWN; t <= QUEEN; t++) count[c][t] = popCount(pos.byType(c, t));
+    }
+}
+
+static uint64_t materialKey(const int count[2][5]) { // four bits per piece count
+    uint64_t key = 0;
+    for (int c = WHITE; c <= BLACK; c++) {
+        for (int t = PAWN; t <= QUEEN; t++) key |= uint64_t(count[c][t]) << (4 * (c * 5 + t));
+    }
+    return key;
+}
+
+static bool blackStronger(const int count[2][5]) { // tables are stored with the stronger side as white
+    int value[2] = {0, 0};
+    for (int c = WHITE; c <= BLACK; c++) {
+        for (int t = PAWN; t <= QUEEN; t++) value[c] += count[c][t] * materialValues[t];
+    }
+    if (value[WHITE] != value[BLACK]) return value[BLACK] > value[WHITE];
+    for (int t = QUEEN; t >= PAWN; t--) {
+        if (count[WHITE][t] != count[BLACK][t]) return count[BLACK][t] > count[WHITE][t];
+    }
+    return false;
+}
+
+static bool trivialDraw(const int count[2][5]) { // bare kings, or one minor piece against a bare king
+    int total = 0;
+    for (int c = WHITE; c <= BLACK; c++) {
+        for (int t = PAWN; t <= QUEEN; t++) total += count[c][t];
+    }
+    if (total == 0) return true;
+    return total == 1 && (count[WHITE][KNIGHT] + count[BLACK][KNIGHT] + count[WHITE][BISHOP] + count[BLACK][BISHOP]) == 1;
+}
+
+static string tableName(int count[2][5]) { // canonical name, flips count to the stored orientation
+    if (blackStronger(count)) swap(count[WHITE], count[BLACK]);
+    string name;
+    for (int c = WHITE; c <= BLACK; c++) {
+        name += 'K';
+        for (int t = QUEEN; t >= PAWN; t--) name += string(count[c][t], pieceLetters[t]);
+    }
+    return name;
+}
+
+static bool parseLayout(const string& name, TableLayout& layout) {
+    if (name.size() < 2 || name[0] != 'K' || name.size() > TB_MAX_PIECES) return false;
+    size_t second = name.find('K', 1);
+    if (second == string::npos) return false;
+    int count[2][5] = {};
+    for (size_t i = 1; i < name.size(); i++) {
+        if (i == second) continue;
+        const char* p = strchr(pieceLetters, name[i]);
+        if (!p || !*p) return false;
+        count[i > second][p - pieceLetters]++;
+    }
+    int canonical[2][5];
+    memcpy(canonical, count, sizeof(count));
+    if (tableName(canonical) != name || trivialDraw(count)) return false; // one spelling per endgame
+
+    layout.name = name;
+    layout.pieceCount = 2;
+    layout.pieces[0] = W_KING;
+    layout.pieces[1] = B_KING;
+    layout.pawns = false;
+    for (int c = WHITE; c <= BLACK; c++) {
+        for (int t = QUEEN; t >= PAWN; t--) {
+            for (int k = 0; k < count[c][t]; k++) layout.pieces[layout.pieceCount++] = makePiece(c, t);
+        }
+    }
+    layout.pawns = count[WHITE][PAWN] + count[BLACK][PAWN] > 0;
+    layout.entries = (layout.pawns ? 32 : 10) * 2;
+    for (int i = 1; i < layout.pieceCount; i++) layout.entries *= 64;
+    return true;
+}
+
+// Mirrors the pieces so the white king lands on files a-d (and for pawnless tables in the a1-d1-d4
+// triangle), then numbers the placement. sq holds the squares in slot order and is modified.
+static uint64_t encodeIndex(const TableLayout& t, int sq[], int stm) {
+    int n = t.pieceCount;
+    if (fileOf(sq[0]) > 3) for (int i = 0; i < n; i++) sq[i] ^= 7;
+    if (!t.pawns) {
+        if (rankOf(sq[0]) > 3) for (int i = 0; i < n; i++) sq[i] ^= 56;
+        if (rankOf(sq[0]) > fileOf(sq[0])) for (int i = 0; i < n; i++) sq[i] = ((sq[i] & 7) << 3) | (sq[i] >> 3);
+    }
+    uint64_t index;
+    if (t.pawns) {
+        index = rankOf(sq[0]) * 4 + fileOf(sq[0]);
+    } else {
+        index = 0;
+        while (triangleSquares[index] != sq[0]) index++;
+    }
+    for (int i = 1; i < n; i++) index = index * 64 + sq[i];
+    return index * 2 + stm;
+}
+
+static void decodeIndex(const TableLayout& t, uint64_t index, int sq[], int& stm) {
+    stm = int(index & 1);
+    index >>= 1;
+    for (int i = t.pieceCount - 1; i >= 1; i--) {
+        sq[i] = int(index & 63);
+        index >>= 6;
+    }
+    sq[0] = t.pawns ? makeSquare(int(index / 4), int(index % 4)) : triangleSquares[index];
+}
+
+static void layoutSquares(const TableLayout& t, const Position& pos, bool flip, int sq[]) {
+    Bitboard remaining[12];
+    for (int p = 0; p < 12; p++) remaining[p] = pos.pieces[p];
+    for (int i = 0; i < t.pieceCount; i++) {
+        int piece = t.pieces[i];
+        int actual = flip ? makePiece(colorOf(piece) ^ 1, typeOf(piece)) : piece;
+        int s = popLsb(remaining[actual]);
+        sq[i] = flip ? s ^ 56 : s;
+    }
+}
+
+static int readEntry(const unsigned char* data, uint64_t index, int bits) {
+    uint64_t bit = index * bits;
+    const unsigned char* p = data + (bit >> 3);
+    int window = p[0] | (p[1] << 8); // entries are at most 8 bits, so two bytes always cover one
+    return (window >> (bit & 7)) & ((1 << bits) - 1);
+}
+
+static bool readHeader(const string& path, TbHeader& header) {
+    ifstream in(path, ios::binary);
+    return in.read(reinterpret_cast<char*>(&header), sizeof(header)) && !memcmp(header.magic, "CETB", 4) && header.version == 1;
+}
+
+static const unsigned char* tableData(Table& table, int kind) { // 0 wdl, 1 dtm; maps on first use
+    const unsigned char* data = table.data[kind].load(memory_order_acquire);
+    if (data) return data;
+    lock_guard<mutex> lock(table.mapLock);
+    data = table.data[kind].load(memory_order_relaxed);
+    if (data || table.failed[kind]) return data;
+    table.failed[kind] = true;
+
+    string path = table.path + (kind ? ".dtm" : ".wdl");
+    TbHeader header;
+    if (!readHeader(path, header) || header.entries != table.layout.entries || !header.bits || header.bits > 8) return nullptr;
+    size_t bytes = sizeof(TbHeader) + (header.entries * header.bits + 7) / 8 + 8;
+    void* base = nullptr;
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && size_t(st.st_size) >= bytes) {
+        base = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (base == MAP_FAILED) base = nullptr;
+    }
+    close(fd);
+    if (!base) return nullptr;
+    madvise(base, bytes, MADV_RANDOM); // probes are scattered, read ahead would only waste memory
+#else
+    ifstream in(path, ios::binary);
+    base = malloc(bytes);
+    if (!base || !in.read(static_cast<char*>(base), bytes)) {
+        free(base);
+        return nullptr;
+    }
+#endif
+    table.mappings.push_back({base, bytes});
+    table.bits[kind] = header.bits;
+    table.failed[kind] = false;
+    data = static_cast<const unsigned char*>(base) + sizeof(TbHeader);
+    table.data[kind].store(data, memory_order_release);
+    return data;
+}
+
+static bool registerTable(const string& directory, const string& name) {
+    TableLayout layout;
+    if (!parseLayout(name, layout)) return false;
+    string path = (filesystem::path(directory) / name).string();
+    if (!filesystem::exists(path + ".wdl") || !filesystem::exists(path + ".dtm")) return false;
+
+    int count[2][5] = {};
+    for (int i = 2; i < layout.pieceCount; i++) count[colorOf(layout.pieces[i])][typeOf(layout.pieces[i])]++;
+    unique_ptr<Table> table(new Table());
+    table->layout = layout;
+    table->path = path;
+    tables[materialKey(count)] = move(table);
+    largestTable = max(largestTable, layout.pieceCount);
+    return true;
+}
+
+// code is the raw entry: 2 bit WDL (1 win, 2 loss) or DTM as described at TbHeader
+static bool probeTable(const Position& pos, int kind, int& code) {
+    if (pos.castlingRights || pos.epSquare != NO_SQUARE || popCount(pos.occupied) > largestTable) return false;
+    int count[2][5];
+    materialCounts(pos, count);
+    bool flip = blackStronger(count);
+    if (flip) swap(count[WHITE], count[BLACK]);
+    if (trivialDraw(count)) {
+        code = 0;
+        return true;
+    }
+    auto it = tables.find(materialKey(count));
+    if (it == tables.end()) return false;
+    Table& table = *it->second;
+    const unsigned char* data = tableData(table, kind);
+    if (!data) return false;
+
+    int sq[TB_MAX_PIECES];
+    layoutSquares(table.layout, pos, flip, sq);
+    code = readEntry(data, encodeIndex(table.layout, sq, flip ? pos.sideToMove ^ 1 : pos.sideToMove), table.bits[kind]);
+    return true;
+}
+
+bool tbInit(const string& directory) {
+    tables.clear();
+    largestTable = 0;
+    error_code error;
+    for (const auto& entry : filesystem::directory_iterator(directory, error)) {
+        if (entry.path().extension() == ".dtm") registerTable(directory, entry.path().stem().string());
+    }
+    return !tables.empty();
+}
+
+int tbLargest() {
+    return largestTable;
+}
+
+bool tbProbeWdl(const Position& pos, int& wdl) {
+    int code;
+    if (!probeTable(pos, 0, code)) return false;
+    wdl = code == 1 ? 1 : code == 2 ? -1 : 0;
+    return true;
+}
+
+bool tbProbeDtm(const Position& pos, int& wdl, int& plies) {
+    int code;
+    if (!probeTable(pos, 1, code)) return false;
+    wdl = code == 0 ? 0 : (code & 1) ? -1 : 1;
+    plies = code == 0 ? 0 : code - 1;
+    return true;
+}
+
+// Retrograde analysis, one pass per distance to mate. Pass n resolves every position that mates
+// or gets mated in exactly n plies: a win needs one move into a position lost in n - 1, a loss
+// needs every move to reach a position won in at most n - 1. Captures and promotions lead into
+// smaller tables, which are generated first and probed from disk. Positions still open when a
+// pass changes nothing (and no smaller table can feed a longer mate) are draws.
+struct Generator {
+    TableLayout layout;
+    unique_ptr<atomic<uint8_t>[]> codes;
+};
+
+static bool setupPosition(const TableLayout& t, uint64_t index, Position& pos) { // false for impossible placements
+    int sq[TB_MAX_PIECES], stm;
+    decodeIndex(t, index, sq, stm);
+    Bitboard used = 0;
+    for (int i = 0; i < t.pieceCount; i++) {
+        if (used & squareBit(sq[i])) return false;
+        if (typeOf(t.pieces[i]) == PAWN && (rankOf(sq[i]) == 0 || rankOf(sq[i]) == 7)) return false;
+        used |= squareBit(sq[i]);
+    }
+    if (kingAttackTable[sq[0]] & squareBit(sq[1])) return false;
+    pos.clear();
+    for (int i = 0; i < t.pieceCount; i++) pos.putPiece(t.pieces[i], sq[i]);
+    pos.sideToMove = stm;
+    return !pos.kingAttacked(stm ^ 1); // the side that just moved cannot be left in check
+}
+
+static int lookupChild(const Generator& g, const Position& child, Move m) { // entry from the child's side to move
+    if (!m.isCapture() && !m.isPromotion()) { // same material, this table; any en passant right is ignored
+        int sq[TB_MAX_PIECES];
+        layoutSquares(g.layout, child, false, sq);
+        return g.codes[encodeIndex(g.layout, sq, child.sideToMove)].load(memory_order_relaxed);
+    }
+    int code;
+    return probeTable(child, 1, code) ? code : 0;
+}
+
+static int combine(int bestWin, int worstLoss, bool allLose, int pass) { // entry for a node, 0 while still open
+    if (bestWin != NO_WIN) return bestWin <= pass + 1 ? bestWin : 0;
+    if (allLose && worstLoss <= pass + 1) return worstLoss;
+    return 0;
+}
+
+static int childEntry(const Generator& g, Position& child, Move m) {
+    int code = lookupChild(g, child, m);
+    if (child.epSquare == NO_SQUARE) return code;
+
+    // After a double push the table entry ignores the en passant capture, so fold it in here.
+    MoveList replies;
+    enumerateCaptures(child, replies);
+    int bestWin = (code && !(code & 1)) ? code : NO_WIN;
+    int worstLoss = (code & 1) ? code : 0;
+    bool allLose = code & 1;
+    for (Move reply : replies) {
+        if (reply.flags() != EN_PASSANT) continue;
+        UndoInfo undo;
+        child.makeMove(reply, undo);
+        int c;
+        if (!probeTable(child, 1, c)) c = 0;
+        if (c & 1) bestWin = min(bestWin, c + 1);
+        else if (c) worstLoss = max(worstLoss, c + 1);
+        else allLose = false;
+        child.unmakeMove(reply, undo);
+    }
+    return combine(bestWin, worstLoss, allLose, 255);
+}
+
+static int resolve(const Generator& g, Position& pos, int pass) {
+    MoveList moves;
+    enumerateAllMoves(pos, moves);
+    if (moves.size() == 0) return pos.inCheck() ? 1 : 0; // checkmate, or stalemate which stays a draw
+    int bestWin = NO_WIN, worstLoss = 0;
+    bool allLose = true;
+    for (Move m : moves) {
+        UndoInfo undo;
+        pos.makeMove(m, undo);
+        int c = childEntry(g, pos, m);
+        if (c & 1) bestWin = min(bestWin, c + 1); // opponent gets mated
+        else if (c) worstLoss = max(worstLoss, c + 1);
+        else allLose = false;
+        pos.unmakeMove(m, undo);
+    }
+    return combine(bestWin, worstLoss, allLose, pass);
+}
+
+static bool writeTable(const Generator& g, const string& path, int kind, int& maxCode) {
+    uint64_t n = g.layout.entries;
+    maxCode = 0;
+    for (uint64_t i = 0; i < n; i++) {
+        int code = g.codes[i].load(memory_order_relaxed);
+        if (code != ILLEGAL) maxCode = max(maxCode, code);
+    }
+    int bits = 2;
+    if (kind) for (bits = 1; (1 << bits) <= maxCode; bits++) {}
+
+    vector<unsigned char> packed((n * bits + 7) / 8 + 8, 0);
+    for (uint64_t i = 0; i < n; i++) {
+        int code = g.codes[i].load(memory_order_relaxed);
+        if (code == ILLEGAL) code = 0;
+        if (!kind) code = code == 0 ? 0 : (code & 1) ? 2 : 1;
+        uint64_t bit = i * bits;
+        packed[bit >> 3] |= (code << (bit & 7)) & 255;
+        packed[(bit >> 3) + 1] |= code >> (8 - (bit & 7));
+    }
+
+    TbHeader header = {};
+    memcpy(header.magic, "CETB", 4);
+    header.version = 1;
+    header.bits = uint8_t(bits);
+    header.maxCode = uint8_t(kind ? maxCode : 2);
+    header.pieces = uint8_t(g.layout.pieceCount);
+    memcpy(header.name, g.layout.name.data(), min(sizeof(header.name), g.layout.name.size()));
+    header.entries = n;
+    ofstream out(path, ios::binary);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(packed.data()), packed.size());
+    return bool(out);
+}
+
+static vector<string> dependencies(const TableLayout& t) { // tables reached by one capture or promotion
+    int count[2][5] = {};
+    for (int i = 2; i < t.pieceCount; i++) count[colorOf(t.pieces[i])][typeOf(t.pieces[i])]++;
+    vector<string> names;
+    for (int c = WHITE; c <= BLACK; c++) {
+        for (int p = PAWN; p <= QUEEN; p++) {
+            if (!count[c][p]) continue;
+            int next[2][5];
+            memcpy(next, count, sizeof(next));
+            next[c][p]--;
+            if (!trivialDraw(next)) names.push_back(tableName(next));
+            if (p != PAWN) continue;
+            for (int promotion = KNIGHT; promotion <= QUEEN; promotion++) {
+                memcpy(next, count, sizeof(next));
+                next[c][PAWN]--;
+                next[c][promotion]++;
+                if (!trivialDraw(next)) names.push_back(tableName(next));
+            }
+        }
+    }
+    return names;
+}
+
+static bool generateTable(const string& directory, const string& name, int threads, set<string>& done) {
+    if (done.count(name)) return true;
+    TableLayout layout;
+    if (!parseLayout(name, layout)) {
+        cout << "Unsupported table " << name << "\n";
+        return false;
+    }
+    if (registerTable(directory, name)) { // already on disk
+        done.insert(name);
+        return true;
+    }
+    int exitBound = 0; // no capture or promotion can lead to a longer mate than this
+    for (const string& dependency : dependencies(layout)) {
+        if (!generateTable(directory, dependency, threads, done)) return false;
+        TbHeader header;
+        if (readHeader((filesystem::path(directory) / dependency).string() + ".dtm", header)) exitBound = max(exitBound, int(header.maxCode));
+    }
+
+    Timer timer;
+    timer.start();
+    Generator g;
+    g.layout = layout;
+    int64_t n = int64_t(layout.entries);
+    g.codes.reset(new atomic<uint8_t>[n]());
+
+    uint64_t mates = 0;
+    #pragma omp parallel for schedule(dynamic, 4096) num_threads(threads) reduction(+:mates)
+    for (int64_t i = 0; i < n; i++) {
+        Position pos;
+        if (!setupPosition(layout, i, pos)) {
+            g.codes[i].store(ILLEGAL, memory_order_relaxed);
+        } else if (resolve(g, pos, 0) == 1) {
+            g.codes[i].store(1, memory_order_relaxed);
+            mates++;
+        }
+    }
+
+    int pass;
+    for (pass = 1; pass < 254; pass++) {
+        uint64_t changed = 0;
+        #pragma omp parallel for schedule(dynamic, 4096) num_threads(threads) reduction(+:changed)
+        for (int64_t i = 0; i < n; i++) {
+            if (g.codes[i].load(memory_order_relaxed)) continue; // resolved or illegal
+            Position pos;
+            setupPosition(layout, i, pos);
+            int code = resolve(g, pos, pass);
+            if (code) {
+                g.codes[i].store(uint8_t(code), memory_order_relaxed);
+                changed++;
+            }
+        }
+        if (!changed && pass > exitBound) break;
+    }
+
+    string path = (filesystem::path(directory) / name).string();
+    int maxCode;
+    if (!writeTable(g, path + ".wdl", 0, maxCode) || !writeTable(g, path + ".dtm", 1, maxCode)) {
+        cout << "Cannot write " << path << "\n";
+        return false;
+    }
+    timer.stop();
+    cout << name << ": " << n << " entries, " << mates << " mates, longest mate " << maxCode - 1
+         << " plies, " << pass << " passes in " << timer.getTime() << " seconds\n";
+    registerTable(directory, name);
+    done.insert(name);
+    return true;
+}
+
+int tbCommand(int argc, char* argv[]) {
+    string usage = "usage: chess tb generate <dir> [--threads N] [tables...] | chess tb probe <dir> <fen>\n";
+    if (argc < 3) {
+        cout << usage;
+        return 1;
+    }
+    string mode = argv[1];
+    string directory = argv[2];
+    initBitboards();
+
+    if (mode == "generate") {
+        int threads = omp_get_max_threads();
+        vector<string> names;
+        for (int i = 3; i < argc; i++) {
+            string arg = argv[i];
+            if (arg == "--threads" && i + 1 < argc) threads = max(1, stoi(argv[++i]));
+            else names.push_back(arg);
+        }
+        if (names.empty()) names = {"KQK", "KRK", "KPK", "KBNK"};
+        error_code error;
+        filesystem::create_directories(directory, error);
+        tbInit(directory);
+        set<string> done;
+        for (const string& name : names) {
+            if (!generateTable(directory, name, threads, done)) return 1;
+        }
+        return 0;
+    }
+    if (mode == "probe" && argc > 3) {
+        string fen;
+        for (int i = 3; i < argc; i++) fen += string(argv[i]) + " ";
+        Position pos;
+        if (!pos.setFromFen(fen)) {
+            cout << "Invalid FEN: " << fen << "\n";
+            return 1;
+        }
+        if (!tbInit(directory)) {
+            cout << "No tables in " << directory << "\n";
+            return 1;
+        }
+        int wdl, plies;
+        if (!tbProbeDtm(pos, wdl, plies)) {
+            cout << "Not in the tablebases\n";
+            return 1;
+        }
+        cout << (wdl > 0 ? "win" : wdl < 0 ? "loss" : "draw");
+        if (wdl) cout << ", mate in " << plies << " plies";
+        cout << "\n";
+        return 0;
+    }
+    cout << usage;
+    return 1;
+}
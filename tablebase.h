@@ -0,0 +1,26 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+#include <string>
+#include "position.h"
+
+// Endgame tablebases for up to four pieces, built here by retrograde analysis. Each endgame has
+// two files: <name>.wdl with 2 bits per position and <name>.dtm with just enough bits per position
+// for the longest distance to mate in it. Files are mapped on first use, never read up front.
+const int TB_MAX_PIECES = 4; // kings included
+
+bool tbInit(const std::string& directory); // registers every table found there, false if none
+int tbLargest();                            // most pieces in any registered table, 0 when none
+
+// Positions with castling rights or an en passant square are never probed. Results are from the
+// side to move's point of view and ignore the fifty move rule.
+bool tbProbeWdl(const Position& pos, int& wdl);   // +1 win, 0 draw, -1 loss
+bool tbProbeDtm(const Position& pos, int& wdl, int& plies); // as above, plus plies to mate unless drawn
+
+// chess tb generate <dir> [--threads N] [tables...] | chess tb probe <dir> <fen>
+int tbCommand(int argc, char* argv[]);
@@ -0,0 +1,60 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+class Timer { // steady clock stopwatch; the elapsed* readings work while it is still running
+    public:
+        void start() {
+            startTime = clock::now();
+            endTime = startTime;
+        }
+        void stop() {
+            endTime = clock::now();
+        }
+        std::string getTime() const {
+            return std::to_string(std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime).count());
+        }
+        long long getMilliseconds() const {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count();
+        }
+        long long getNanoseconds() const {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime).count();
+        }
+        long long elapsedMilliseconds() const {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - startTime).count();
+        }
+        long long elapsedNanoseconds() const {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - startTime).count();
+        }
+    private:
+        typedef std::chrono::steady_clock clock;
+        clock::time_point startTime;
+        clock::time_point endTime;
+};
+
+// Adds the lifetime of a scope to a nanosecond counter. Two clock reads cost more than a
+// whole move generation, so PROFILE_SCOPE only expands to one in CHESS_PROFILE builds.
+class ScopedTimer {
+    public:
+        explicit ScopedTimer(uint64_t& total) : total(total), startTime(std::chrono::steady_clock::now()) {}
+        ~ScopedTimer() {
+            total += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+        }
+    private:
+        uint64_t& total;
+        std::chrono::steady_clock::time_point startTime;
+};
+
+#ifdef CHESS_PROFILE
+#define PROFILE_SCOPE(counter) ScopedTimer scopedTimer(counter)
+#else
+#define PROFILE_SCOPE(counter)
+#endif
@@ -0,0 +1,150 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include <cstdlib>
+#include <cstring>
+#include "search.h"
+#include "tt.h"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+using namespace std;
+
+// data word: move (16 bits) | score (32 bits) | depth (8 bits) | bound (2 bits) | generation (6 bits)
+static inline uint64_t packEntry(Move move, int score, int depth, int bound, int generation) {
+    return uint64_t(move.raw()) | (uint64_t(uint32_t(score)) << 16) | (uint64_t(depth & 255) << 48)
+         | (uint64_t(bound) << 56) | (uint64_t(generation) << 58);
+}
+static inline int entryDepth(uint64_t data) { return int((data >> 48) & 255); }
+static inline int entryBound(uint64_t data) { return int((data >> 56) & 3); }
+static inline int entryGeneration(uint64_t data) { return int(data >> 58); }
+
+TranspositionTable::~TranspositionTable() {
+    release();
+}
+
+void TranspositionTable::release() {
+    if (!clusters) return;
+#ifdef __linux__
+    if (mapped) munmap(clusters, allocatedBytes);
+    else free(clusters);
+#else
+    free(clusters);
+#endif
+    clusters = nullptr;
+    clusterCount = 0;
+}
+
+void TranspositionTable::resize(size_t mb, bool hugePages) {
+    release();
+    megabytes = max<size_t>(1, mb);
+    clusterCount = megabytes * 1024 * 1024 / sizeof(Cluster);
+    allocatedBytes = clusterCount * sizeof(Cluster);
+    hugePagesActive = false;
+    mapped = false;
+
+#ifdef __linux__
+    if (hugePages) { // explicit huge pages first, they need to be reserved by the administrator
+        size_t bytes = (allocatedBytes + (2 << 20) - 1) & ~size_t((2 << 20) - 1);
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            clusters = static_cast<Cluster*>(p);
+            allocatedBytes = bytes;
+            hugePagesActive = mapped = true;
+        }
+    }
+#endif
+    if (!clusters) {
+        size_t alignment = hugePages ? (2 << 20) : 64;
+        size_t bytes = (allocatedBytes + alignment - 1) & ~(alignment - 1);
+        clusters = static_cast<Cluster*>(aligned_alloc(alignment, bytes));
+        if (!clusters) {
+            clusterCount = allocatedBytes = megabytes = 0;
+            return;
+        }
+        allocatedBytes = bytes;
+#ifdef MADV_HUGEPAGE
+        if (hugePages) hugePagesActive = madvise(clusters, bytes, MADV_HUGEPAGE) == 0; // transparent huge pages
+#endif
+    }
+    clear();
+}
+
+void TranspositionTable::clear() {
+    memset(static_cast<void*>(clusters), 0, clusterCount * sizeof(Cluster));
+    generation = 0;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const {
+    if (!clusterCount) return false;
+    const Cluster& cluster = clusters[index(key)];
+    for (const Slot& slot : cluster.slots) {
+        uint64_t data = slot.data.load(memory_order_relaxed);
+        if ((slot.check.load(memory_order_relaxed) ^ data) == key && data) {
+            entry.move = Move::fromRaw(uint16_t(data));
+            entry.score = int32_t(uint32_t(data >> 16));
+            entry.depth = entryDepth(data);
+            entry.bound = entryBound(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, Move move, int score, int depth, int bound) {
+    if (!clusterCount) return;
+    Cluster& cluster = clusters[index(key)];
+    Slot* replace = &cluster.slots[0];
+    int worst = INT32_MAX;
+
+    for (Slot& slot : cluster.slots) {
+        uint64_t data = slot.data.load(memory_order_relaxed);
+        if ((slot.check.load(memory_order_relaxed) ^ data) == key) { // same position, refresh it
+            if (move.isNone()) move = Move::fromRaw(uint16_t(data)); // keep the old best move
+            if (bound != BOUND_EXACT && depth + 2 < entryDepth(data) && entryGeneration(data) == generation) return;
+            replace = &slot;
+            break;
+        }
+        // otherwise evict the shallowest entry, counting old searches as much shallower
+        int value = entryDepth(data) - 8 * ((generation - entryGeneration(data)) & 63);
+        if (value < worst) {
+            worst = value;
+            replace = &slot;
+        }
+    }
+
+    uint64_t data = packEntry(move, score, depth, bound, generation);
+    replace->data.store(data, memory_order_relaxed);
+    replace->check.store(key ^ data, memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const {
+    size_t samples = min<size_t>(clusterCount, 250);
+    int used = 0;
+    for (size_t i = 0; i < samples; i++) {
+        for (const Slot& slot : clusters[i].slots) {
+            uint64_t data = slot.data.load(memory_order_relaxed);
+            if (data && entryGeneration(data) == generation) used++;
+        }
+    }
+    return samples ? int(used * 1000 / (samples * 4)) : 0;
+}
+
+// Mates and tablebase wins both count down with the distance from the root; everything at or
+// above the lowest tablebase score is one of them.
+int scoreToTT(int score, int ply) {
+    if (score >= TB_WIN_SCORE - MAX_PLY) return score + ply;
+    if (score <= -TB_WIN_SCORE + MAX_PLY) return score - ply;
+    return score;
+}
+
+int scoreFromTT(int score, int ply) {
+    if (score >= TB_WIN_SCORE - MAX_PLY) return score - ply;
+    if (score <= -TB_WIN_SCORE + MAX_PLY) return score + ply;
+    return score;
+}
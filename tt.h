@@ -0,0 +1,67 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "move.h"
+
+enum Bound { BOUND_NONE, BOUND_UPPER, BOUND_LOWER, BOUND_EXACT };
+
+struct TTEntry { // unpacked copy of a table slot
+    Move move;
+    int score;
+    int depth;
+    int bound;
+};
+
+// Shared hash table of searched positions. Every slot is two 64-bit words: the packed entry and the
+// entry XORed with the position key. Threads read and write slots without locks; a slot torn by a
+// concurrent write no longer XORs back to the key and is simply treated as a miss.
+class TranspositionTable {
+    public:
+        TranspositionTable() {}
+        ~TranspositionTable();
+        TranspositionTable(const TranspositionTable&) = delete;
+        TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+        void resize(size_t megabytes, bool hugePages = false);
+        void clear();
+        void newSearch() { generation = (generation + 1) & 63; } // ages entries left from earlier searches
+
+        bool probe(uint64_t key, TTEntry& entry) const;
+        void store(uint64_t key, Move move, int score, int depth, int bound);
+        void prefetch(uint64_t key) const { __builtin_prefetch(&clusters[index(key)]); }
+
+        int hashfull() const; // permille of sampled slots used by the current search
+        size_t sizeMegabytes() const { return megabytes; }
+        bool usingHugePages() const { return hugePagesActive; }
+
+    private:
+        struct Slot {
+            std::atomic<uint64_t> check; // key ^ data
+            std::atomic<uint64_t> data;
+        };
+        struct alignas(64) Cluster { // one cache line
+            Slot slots[4];
+        };
+
+        size_t index(uint64_t key) const { return size_t(((unsigned __int128)key * clusterCount) >> 64); }
+        void release();
+
+        Cluster* clusters = nullptr;
+        size_t clusterCount = 0;
+        size_t allocatedBytes = 0;
+        size_t megabytes = 0;
+        bool hugePagesActive = false;
+        bool mapped = false;
+        int generation = 0;
+};
+
+int scoreToTT(int score, int ply);   // mate and tablebase scores are stored relative to the node, not the root
+int scoreFromTT(int score, int ply);
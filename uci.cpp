@@ -0,0 +1,293 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include "movegen.h"
+#include "nnue.h"
+#include "tablebase.h"
+#include "uci.h"
+
+using namespace std;
+
+static mutex outputMutex; // info lines come from the search thread, everything else from the reader
+
+static void send(const string& line) {
+    lock_guard<mutex> lock(outputMutex);
+    cout << line << endl;
+}
+
+struct UciState {
+    Engine& engine;
+    OpeningBook& book;
+    Position position;
+    thread searchThread;
+    mutex waitMutex;
+    condition_variable waitSignal;
+    bool stopSignal = false; // lets an infinite or pondering search hand in its bestmove
+    bool useNnue = nnueEnabled; // UseNNUE, honoured once an EvalFile has loaded
+
+    UciState(Engine& e, OpeningBook& b) : engine(e), book(b) { position.setStartPosition(); }
+};
+
+string scoreString(int score) { // our pawn is 10 so cp = score * 10
+    if (abs(score) >= MATE_SCORE - MAX_PLY) {
+        int plies = MATE_SCORE - abs(score);
+        return "mate " + to_string(score > 0 ? (plies + 1) / 2 : -(plies + 1) / 2);
+    }
+    if (abs(score) >= TB_WIN_SCORE - MAX_PLY) { // tablebase win, shown as a huge but finite advantage
+        int plies = TB_WIN_SCORE - abs(score);
+        return "cp " + to_string(score > 0 ? 20000 - plies : plies - 20000);
+    }
+    return "cp " + to_string(score * 10);
+}
+
+string infoString(const SearchResult& r, const Position& root, const Engine& engine) {
+    long long ms = max(1LL, r.timeMs);
+    int lineCount = max(1, int(r.lines.size()));
+    ostringstream out;
+    for (int k = 0; k < lineCount; k++) {
+        int score = r.lines.empty() ? r.score : r.lines[k].score;
+        const Move* pv = r.lines.empty() ? r.pv : r.lines[k].pv;
+        int pvLength = r.lines.empty() ? r.pvLength : r.lines[k].pvLength;
+        if (k) out << "\n";
+        out << "info depth " << r.depth;
+        if (engine.options.multiPV > 1) out << " multipv " << k + 1;
+        out << " score " << scoreString(root.sideToMove == WHITE ? score : -score)
+            << " nodes " << r.nodes << " nps " << r.nodes * 1000 / ms << " time " << r.timeMs
+            << " hashfull " << engine.tt.hashfull() << " pv";
+        for (int i = 0; i < pvLength; i++) out << " " << moveToString(pv[i]);
+    }
+    return out.str();
+}
+
+static bool applyMove(Position& pos, const string& lan) { // legal long algebraic move, false otherwise
+    Move m = parseMove(pos, lan);
+    if (m.isNone()) return false;
+    UndoInfo undo;
+    pos.makeMove(m, undo);
+    return true;
+}
+
+static void stopSearch(UciState& s) {
+    {
+        lock_guard<mutex> lock(s.waitMutex);
+        s.stopSignal = true;
+    }
+    s.waitSignal.notify_all();
+    s.engine.stop();
+    if (s.searchThread.joinable()) s.searchThread.join();
+}
+
+static void startSearch(UciState& s, const SearchLimits& limits, bool ponder = false) {
+    stopSearch(s);
+    s.stopSignal = false;
+    s.engine.pondering = ponder; // before the thread starts, so an early ponderhit is not lost
+    s.engine.newSearch();        // and an early stop neither
+    Position root = s.position;
+    s.engine.onIteration = [&s, root](const SearchResult& r) { send(infoString(r, root, s.engine)); };
+    s.searchThread = thread([&s, root, limits, ponder]() {
+        SearchResult result = s.engine.search(root, limits);
+        if (limits.infinite || ponder) { // the protocol forbids a bestmove before stop, or ponderhit when pondering
+            unique_lock<mutex> lock(s.waitMutex);
+            s.waitSignal.wait(lock, [&s, &limits]() { return s.stopSignal || (!limits.infinite && !s.engine.pondering); });
+        }
+        send(infoString(result, root, s.engine));
+        string line = "bestmove " + (result.bestMove.isNone() ? string("0000") : moveToString(result.bestMove));
+        if (result.pvLength > 1) line += " ponder " + moveToString(result.pv[1]);
+        send(line);
+    });
+}
+
+bool parsePosition(istream& in, Position& pos, string& error) {
+    string token, fen;
+    pos.clear();
+    in >> token;
+    if (token == "startpos") {
+        fen = START_FEN;
+        in >> token; // "moves", if any
+    } else if (token == "fen") {
+        while (in >> token && token != "moves") fen += token + " ";
+    } else {
+        error = "position wants startpos or fen";
+        return false;
+    }
+    if (!pos.setFromFen(fen)) {
+        error = "invalid fen " + fen;
+        return false;
+    }
+    while (in >> token) {
+        if (!applyMove(pos, token)) {
+            error = "illegal move " + token; // pos keeps the moves before it
+            return false;
+        }
+    }
+    return true;
+}
+
+SearchLimits parseGo(istream& in, bool& ponder) {
+    SearchLimits limits;
+    ponder = false;
+    string token;
+    while (in >> token) {
+        if (token == "wtime") in >> limits.time[WHITE];
+        else if (token == "btime") in >> limits.time[BLACK];
+        else if (token == "winc") in >> limits.inc[WHITE];
+        else if (token == "binc") in >> limits.inc[BLACK];
+        else if (token == "movestogo") in >> limits.movestogo;
+        else if (token == "depth") in >> limits.depth;
+        else if (token == "nodes") in >> limits.nodes;
+        else if (token == "movetime") in >> limits.movetime;
+        else if (token == "infinite") limits.infinite = true;
+        else if (token == "ponder") ponder = true;
+    }
+    return limits;
+}
+
+static void position(UciState& s, istringstream& in) {
+    Position pos;
+    string error;
+    if (!parsePosition(in, pos, error)) {
+        send("info string " + error);
+        if (pos.occupied == 0) return; // nothing usable, keep the old position
+    }
+    s.position = pos;
+}
+
+static void go(UciState& s, istringstream& in) {
+    bool ponder; // the position already has the move we expect the opponent to play
+    SearchLimits limits = parseGo(in, ponder);
+    Move bookMove = limits.infinite || ponder ? Move() : s.book.probe(s.position);
+    if (!bookMove.isNone()) {
+        stopSearch(s);
+        send("bestmove " + moveToString(bookMove));
+        return;
+    }
+    startSearch(s, limits, ponder);
+}
+
+static void ponderhit(UciState& s) { // the opponent played the expected move, keep searching on our own clock
+    {
+        lock_guard<mutex> lock(s.waitMutex);
+        s.engine.ponderhit();
+    }
+    s.waitSignal.notify_all(); // a search that already finished while pondering may answer now
+}
+
+static bool isSearchParameter(const string& name) {
+    for (int i = 0; i < searchParameterCount; i++) {
+        if (name == searchParameters[i].name) return true;
+    }
+    return false;
+}
+
+static void setOption(UciState& s, istringstream& in) {
+    string token, name, value;
+    in >> token; // "name"
+    while (in >> token && token != "value") name += (name.empty() ? "" : " ") + token;
+    getline(in >> ws, value);
+    stopSearch(s);
+    if (name == "Ponder") {} // only tells us the GUI may send go ponder, nothing to set up
+    else if (name == "StatsFile") s.engine.options.statsFile = value == "<empty>" ? "" : value;
+    else if (name == "TablebasePath") {
+        if (!tbInit(value == "<empty>" ? "" : value) && value != "<empty>") send("info string no tablebases in " + value);
+    } else if (name == "EvalFile") {
+        if (nnueLoad(value)) send(string("info string loaded network ") + value + " using " + nnueKernel());
+        else send("info string cannot load network " + value);
+        nnueEnabled = s.useNnue && nnueLoaded();
+    } else if (name == "UseNNUE") {
+        s.useNnue = value == "true";
+        nnueEnabled = s.useNnue && nnueLoaded();
+        if (s.useNnue && !nnueEnabled) send("info string no network loaded, set EvalFile");
+    } else if (name == "BookFile") {
+        s.book.close();
+        if (value != "<empty>" && !s.book.open(value)) send("info string cannot open book " + value);
+    } else if (name == "Hash" || name == "Threads" || name == "Move Overhead" || name == "MultiPV"
+               || name == "Branches" || name == "BeamPly" || isSearchParameter(name)) {
+        int number;
+        try {
+            number = stoi(value);
+        } catch (...) { // a GUI or a typo must not take the engine down
+            send("info string invalid value " + value + " for " + name);
+            return;
+        }
+        if (name == "Hash") s.engine.tt.resize(max(1, number));
+        else if (name == "Threads") s.engine.options.threads = max(1, number);
+        else if (name == "Move Overhead") s.engine.options.moveOverhead = max(0, number);
+        else if (name == "MultiPV") s.engine.options.multiPV = max(1, number);
+        else if (name == "Branches") s.engine.options.branches = max(1, number);
+        else if (name == "BeamPly") s.engine.options.beamPly = max(0, number);
+        else setSearchParameter(s.engine.options, name, number);
+    }
+    else send("info string unknown option " + name);
+}
+
+static bool handle(UciState& s, const string& line) { // false on quit
+    istringstream in(line);
+    string command;
+    in >> command;
+
+    if (command == "uci") {
+        send("id name Chess Engine V0.5");
+        send("id author Tommy Ciccone");
+        send("option name Hash type spin default " + to_string(s.engine.tt.sizeMegabytes()) + " min 1 max 65536");
+        send("option name Threads type spin default " + to_string(s.engine.options.threads) + " min 1 max 1024");
+        send("option name Move Overhead type spin default " + to_string(s.engine.options.moveOverhead) + " min 0 max 5000");
+        send("option name MultiPV type spin default " + to_string(s.engine.options.multiPV) + " min 1 max 256");
+        send("option name Branches type spin default " + to_string(s.engine.options.branches) + " min 1 max 256");
+        send("option name BeamPly type spin default " + to_string(s.engine.options.beamPly) + " min 0 max 128");
+        send("option name Ponder type check default false");
+        for (int i = 0; i < searchParameterCount; i++) {
+            const SearchParameter& p = searchParameters[i];
+            send(string("option name ") + p.name + " type spin default " + to_string(s.engine.options.*p.value)
+                 + " min " + to_string(p.min) + " max " + to_string(p.max));
+        }
+        send("option name TablebasePath type string default <empty>");
+        send("option name BookFile type string default <empty>");
+        send("option name EvalFile type string default <empty>");
+        send("option name StatsFile type string default <empty>");
+        send(string("option name UseNNUE type check default ") + (nnueEnabled ? "true" : "false"));
+        send("uciok");
+    } else if (command == "isready") {
+        send("readyok");
+    } else if (command == "ucinewgame") {
+        stopSearch(s);
+        s.engine.clear();
+    } else if (command == "position") {
+        stopSearch(s);
+        position(s, in);
+    } else if (command == "go") {
+        go(s, in);
+    } else if (command == "ponderhit") {
+        ponderhit(s);
+    } else if (command == "stop") {
+        stopSearch(s);
+    } else if (command == "setoption") {
+        setOption(s, in);
+    } else if (command == "d") {
+        send(s.position.fen());
+    } else if (command == "quit") {
+        return false;
+    } else if (!command.empty()) {
+        send("info string unknown command " + command);
+    }
+    return true;
+}
+
+int uciLoop(Engine& engine, OpeningBook& book, const string& firstCommand) {
+    UciState s(engine, book);
+    string line;
+    bool running = firstCommand.empty() || handle(s, firstCommand);
+    while (running && getline(cin, line)) {
+        running = handle(s, line);
+    }
+    stopSearch(s);
+    engine.onIteration = nullptr;
+    return 0;
+}
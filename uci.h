@@ -0,0 +1,24 @@
+/*
+ * Chess Engine V0.5
+ *
+ * (C) 2025 Tommy Ciccone All Rights Reserved.
+*/
+
+#pragma once
+
+#include <istream>
+#include <string>
+#include "book.h"
+#include "search.h"
+
+// Universal Chess Interface front end. Commands are read from stdin on the calling thread while
+// searches run on their own thread, so stop and isready are answered at once mid-search.
+// firstCommand is handled before reading stdin, for when the caller already consumed "uci".
+// Moves found in the book are played at once instead of searching.
+int uciLoop(Engine& engine, OpeningBook& book, const std::string& firstCommand = "");
+
+// Protocol pieces shared with the game server and the cluster.
+bool parsePosition(std::istream& in, Position& pos, std::string& error); // rest of a position command
+SearchLimits parseGo(std::istream& in, bool& ponder);                   // rest of a go command
+std::string scoreString(int score); // "cp N" or "mate N", score from the side to move's point of view
+std::string infoString(const SearchResult& r, const Position& root, const Engine& engine); // one line per MultiPV line